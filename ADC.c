@@ -1,10 +1,41 @@
 #include "ADC.h"
 #include "TM4C123GH6PM.h"
+#include "GPIO_HAL.h"
+#include "Profile.h"
+#include "Timer.h"
+
+_Static_assert((ADC_RING_SIZE & (ADC_RING_SIZE - 1)) == 0, "ADC_RING_SIZE must be a power of two");
+
+// Ring buffer of raw results. The SS0 interrupt moves the head, main moves the tail
+static uint16_t ring[ADC_RING_SIZE];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+static volatile uint32_t overrun_count = 0;
+
+// Filtered result, scaled by 2^ADC_FILTER_SHIFT to keep the fraction
+static volatile uint32_t filtered_scaled = 0;
+static volatile uint8_t filter_primed = 0;
+
+// Latest potentiometer result, set by the SS0 interrupt
+static volatile uint16_t pot_counts = 0;
+static volatile uint8_t pot_new = 0;
+
+// Rate asked for by each user of the sequence; Timer3A runs at the fastest
+static uint32_t requested_rate[ADC_USER_COUNT];
+
+// Time between conversions at the current rate
+static uint32_t sample_period_us = 1000000 / ADC_SAMPLE_RATE_HZ;
+
+// Digital comparator 0 watching the light sensor (see ADC_Comparator_Start)
+static volatile uint8_t comparator_event = 0;
+static uint16_t comparator_min_count = 1;
+static uint16_t comparator_count = 0;
+static uint64_t comparator_last_us = 0;
 
 /**
- * @brief Initializes ADC0 for sampling only the light sensor (PE1).
+ * @brief Initializes ADC0 for sampling the potentiometer (PE2) and the light sensor (PE1).
  *
- * This temporary setup is used for debugging the light sensor.
+ * Conversions are triggered by Timer3A and read by the SS0 interrupt.
  */
 void ADC_Init(void)
 {
@@ -12,61 +43,366 @@ void ADC_Init(void)
 	SYSCTL->RCGCADC |= 0x01;      // Enable ADC0 clock
 	SysTick_Delay1ms(1);          // 1 ms delay after enabling clock
 
-	// Enable clock for GPIO Port E (for PE1)
+	// Select the bus aperture of the GPIO ports
+	GPIO_Bus_Init();
+
+	// Enable clock for GPIO Port E (for PE1 and PE2)
 	SYSCTL->RCGCGPIO |= 0x10;     // Set bit 4 to enable Port E clock
 
 	// Wait for Port E to be ready
 	while ((SYSCTL->PRGPIO & 0x10) == 0); // Wait for Port E ready
 
-	// Set PE1 as input
-	GPIOE->DIR &= ~0x02;         // PE1 as input
+	// Set PE1 and PE2 as inputs
+	GPIO_PORTE->DIR &= ~0x06;         // PE1, PE2 as input
 
-	// Disable digital function on PE1
-	GPIOE->DEN &= ~0x02;         // Disable digital function on PE1
+	// Disable digital function on PE1 and PE2
+	GPIO_PORTE->DEN &= ~0x06;         // Disable digital function on PE1, PE2
 
-	// Enable analog mode on PE1
-	GPIOE->AMSEL |= 0x02;        // Enable analog mode on PE1
+	// Enable analog mode on PE1 and PE2
+	GPIO_PORTE->AMSEL |= 0x06;        // Enable analog mode on PE1, PE2
 
-	// Enable alternate function for PE1
-	GPIOE->AFSEL |= 0x02;        // Set bit 1 for alternate function
+	// Enable alternate function for PE1 and PE2
+	GPIO_PORTE->AFSEL |= 0x06;        // Set bits 1 and 2 for alternate function
 
 	// Disable Sample Sequencer 0 during configuration
 	ADC0->ACTSS &= ~0x01;        // Disable SS0 during config
 
-	// Configure SS0 for software trigger
-	ADC0->EMUX &= ~0x000F;       // Set bits 3:0 for software trigger on SS0
+	// Configure SS0 for the timer trigger
+	ADC0->EMUX = (ADC0->EMUX & ~0x000F) | 0x0005;
 
-	// Set the sequence: Only sample channel 2 (PE1)
-	ADC0->SSMUX0 = 0x00000002;   // First = AIN2 (PE1)
+	// Average 16 conversions in hardware for each result
+	ADC0->SAC = 0x4;
 
-	// Configure SSCTL0: Interrupt enable (IE0), End of sequence (END0)
-	ADC0->SSCTL0 = 0x00000006;   // Bit 1 (IE0) and Bit 2 (END0) set
+	// Set the sequence: potentiometer first, light sensor after
+	ADC0->SSMUX0 = 0x00000021;   // First = AIN1 (PE2), Second = AIN2 (PE1)
+
+	// Configure SSCTL0: Interrupt enable (IE1), End of sequence (END1) on the second step
+	ADC0->SSCTL0 = 0x00000060;   // Bit 5 (END1) and Bit 6 (IE1) set
+
+	// Send the SS0 interrupt to the NVIC
+	ADC0->ISC = 0x01;
+	ADC0->IM |= 0x01;
+	NVIC_EnableIRQ(ADC0SS0_IRQn);
 
 	// Re-enable Sample Sequencer 0
 	ADC0->ACTSS |= 0x01;         // Enable SS0
+
+	// Configure the trigger timer, left stopped
+	Timer3A_Init_ADC_Trigger(ADC_SAMPLE_RATE_HZ);
+}
+
+void ADC_Set_Rate(ADC_User user, uint32_t rate_hz)
+{
+	uint32_t rate = 0;
+
+	requested_rate[user] = rate_hz;
+	for (uint8_t i = 0; i < ADC_USER_COUNT; i++)
+	{
+		if (requested_rate[i] > rate)
+		{
+			rate = requested_rate[i];
+		}
+	}
+
+	if (rate == 0)
+	{
+		Timer3A_Stop();
+		return;
+	}
+
+	// Restarting the count applies a new rate at once
+	sample_period_us = 1000000 / rate;
+	Timer3A_Set_Rate(rate);
+	Timer3A_Start();
+}
+
+void ADC_Start(uint32_t rate_hz)
+{
+	filter_primed = 0;
+	ADC_Set_Rate(ADC_USER_LIGHT, rate_hz);
+}
+
+void ADC_Comparator_Start(uint16_t low_counts, uint16_t high_counts, uint16_t min_count)
+{
+	// Disable Sample Sequencer 0 during configuration
+	ADC0->ACTSS &= ~0x01;
+
+	// No more FIFO interrupts: the light sensor step goes to comparator 0 instead of the FIFO
+	ADC0->IM &= ~0x01;
+	ADC0->SSOP0 = 0x10;          // S1DCOP: step 1 to a digital comparator
+	ADC0->SSDC0 = 0x00;          // S1DCSEL: comparator 0
+
+	// Low band below low_counts, high band from high_counts up
+	ADC0->DCCMP0 = ((uint32_t)(high_counts & 0x0FFF) << 16) | (low_counts & 0x0FFF);
+
+	// CIE, low band (CIC = 0), hysteresis-always (CIM = 2): an interrupt for
+	// every result in the low band, and in the mid band after it, until a
+	// result reaches the high band
+	ADC0->DCCTL0 = 0x12;
+
+	// Forget any earlier band of comparator 0
+	ADC0->DCRIC = 0x00010001;
+	ADC0->DCISC = 0x01;
+
+	comparator_min_count = (min_count == 0) ? 1 : min_count;
+	comparator_count = 0;
+	comparator_event = 0;
+
+	// Send comparator interrupts on the SS0 line (DCONSS0)
+	ADC0->IM |= 0x10000;
+
+	// Re-enable Sample Sequencer 0
+	ADC0->ACTSS |= 0x01;
 }
 
 /**
- * @brief Starts the ADC conversion and reads result from PE1 (light sensor).
+ * @brief Empties the SS0 FIFO and clears its overflow flag. SS0 must be disabled.
  *
- * @param analog_value_buffer Array to store the sampled value
+ * With the sequencer stopped no half sequence can arrive, so the FIFO
+ * starts again on a potentiometer result.
  */
-void ADC_Sample(double analog_value_buffer[])
+static void ADC_Empty_FIFO(void)
+{
+	while ((ADC0->SSFSTAT0 & 0x100) == 0)
+	{
+		(void)ADC0->SSFIFO0;
+	}
+	ADC0->OSTAT = 0x01;
+}
+
+void ADC_Comparator_Stop(void)
 {
-	// Start sampling using SS0
-	ADC0->PSSI = 0x01; // Set bit 0 to initiate SS0
+	ADC0->ACTSS &= ~0x01;
 
-	// Wait for conversion to complete
-	while ((ADC0->RIS & 0x01) == 0); // Wait until RIS0 is set
+	// Comparator off, step 1 back to the FIFO
+	ADC0->IM &= ~0x10000;
+	ADC0->DCCTL0 = 0x00;
+	ADC0->SSOP0 = 0x00;
+	ADC0->DCISC = 0x01;
+
+	// Drop the potentiometer results left alone in the FIFO, so it starts on a full sequence
+	ADC_Empty_FIFO();
+
+	// A stale end-of-sequence flag would drain an empty FIFO
+	ADC0->ISC = 0x01;
+	ADC0->IM |= 0x01;
+
+	ADC0->ACTSS |= 0x01;
+}
+
+uint8_t ADC_Comparator_Has_Event(void)
+{
+	return comparator_event;
+}
 
-	// Read result from FIFO (PE1 only)
-	unsigned int result_pe1 = ADC0->SSFIFO0 & 0x0FFF; // PE1 - Light Sensor
+uint8_t ADC_Take_Comparator_Event(void)
+{
+	if (!comparator_event)
+	{
+		return 0;
+	}
+
+	comparator_event = 0;
+	return 1;
+}
+
+/**
+ * @brief Counts one comparator interrupt and raises the event after min_count in a row.
+ */
+static void ADC_Comparator_Step(void)
+{
+	uint64_t now_us = SysTick_Now_us();
+
+	// In hysteresis-always mode every result interrupts until one reaches the
+	// high band, so a missing interrupt means the sensor was uncovered
+	if ((now_us - comparator_last_us) > (sample_period_us + (sample_period_us / 2)))
+	{
+		comparator_count = 0;
+	}
+	comparator_last_us = now_us;
+
+	if (++comparator_count >= comparator_min_count)
+	{
+		// A single event: no more interrupts until the comparator is restarted
+		ADC0->DCCTL0 &= ~0x10;
+		comparator_event = 1;
+	}
+}
+
+/**
+ * @brief Returns the number of results in the SS0 FIFO (SSFSTAT0 pointers and FULL).
+ */
+static uint8_t ADC_FIFO_Count(void)
+{
+	uint32_t status = ADC0->SSFSTAT0;
+
+	if (status & 0x1000)
+	{
+		return 8;
+	}
+	return (uint8_t)((((status >> 4) & 0x0F) - (status & 0x0F)) & 0x07);
+}
+
+/**
+ * @brief Moves every complete sequence from the SS0 FIFO into the ring buffer.
+ */
+static void ADC_Drain_FIFO(void)
+{
+	// Results lost in the FIFO itself may have split a sequence, so the
+	// pairing cannot be trusted: drop everything and start on the next one
+	if (ADC0->OSTAT & 0x01)
+	{
+		overrun_count++;
+		ADC0->ACTSS &= ~0x01;
+		ADC_Empty_FIFO();
+		ADC0->ACTSS |= 0x01;
+		return;
+	}
+
+	// Drain complete sequences only. A lone potentiometer result belongs to a
+	// sequence still converting and stays for the next interrupt
+	while (ADC_FIFO_Count() >= 2)
+	{
+		pot_counts = ADC0->SSFIFO0 & 0x0FFF;
+		pot_new = 1;
+
+		uint16_t result = ADC0->SSFIFO0 & 0x0FFF;
+
+		// Exponential moving average; the first result primes it
+		if (!filter_primed)
+		{
+			filtered_scaled = (uint32_t)result << ADC_FILTER_SHIFT;
+			filter_primed = 1;
+		}
+		else
+		{
+			filtered_scaled = filtered_scaled - (filtered_scaled >> ADC_FILTER_SHIFT) + result;
+		}
+
+		uint32_t head = ring_head;
+		if ((head - ring_tail) >= ADC_RING_SIZE)
+		{
+			overrun_count++;
+		}
+		else
+		{
+			ring[head & (ADC_RING_SIZE - 1)] = result;
+			__DMB();
+			ring_head = head + 1;
+		}
+	}
+}
+
+/**
+ * @brief Handles the SS0 FIFO and the digital comparator interrupts.
+ */
+void ADC0SS0_Handler(void)
+{
+	PROFILE_BEGIN(PROFILE_ADC0SS0_ISR);
+
+	// Digital comparator 0 (clearing DCISC also clears DCINSS0)
+	if (ADC0->DCISC & 0x01)
+	{
+		ADC0->DCISC = 0x01;
+		ADC_Comparator_Step();
+	}
+
+	// End of sequence; masked while the step goes to the comparator
+	if (ADC0->ISC & 0x01)
+	{
+		// Clear the interrupt first so a result that arrives while draining raises it again
+		ADC0->ISC = 0x01;
+		ADC_Drain_FIFO();
+	}
+
+	PROFILE_END(PROFILE_ADC0SS0_ISR);
+}
+
+uint8_t ADC_Has_Samples(void)
+{
+	return ring_head != ring_tail;
+}
+
+uint8_t ADC_Potentiometer_Has_New(void)
+{
+	return pot_new;
+}
+
+uint8_t ADC_Take_Potentiometer(uint16_t* counts)
+{
+	if (!pot_new)
+	{
+		return 0;
+	}
+
+	pot_new = 0;
+	*counts = pot_counts;
+	return 1;
+}
+
+uint16_t ADC_Get_Filtered(void)
+{
+	return (uint16_t)(filtered_scaled >> ADC_FILTER_SHIFT);
+}
+
+uint8_t ADC_Read_Samples(uint16_t samples[], uint8_t max_count)
+{
+	uint8_t count = 0;
+	uint32_t tail = ring_tail;
+
+	while ((count < max_count) && (tail != ring_head))
+	{
+		__DMB();
+		samples[count++] = ring[tail & (ADC_RING_SIZE - 1)];
+		tail++;
+	}
+
+	__DMB();
+	ring_tail = tail;
+	return count;
+}
+
+uint32_t ADC_Get_Overrun_Count(void)
+{
+	return overrun_count;
+}
+
+void ADC_Read(ADC_Reading* reading)
+{
+	PROFILE_BEGIN(PROFILE_ADC_READ);
+
+	uint16_t counts = ADC_Get_Filtered();
+
+	reading->light_raw = counts;
+	reading->light_mv = (uint16_t)ADC_COUNTS_TO_MV(counts);
+
+	PROFILE_END(PROFILE_ADC_READ);
+}
+
+uint8_t ADC_Counts_To_8bit(uint16_t counts)
+{
+	if (counts >= ADC_FULL_SCALE)
+	{
+		return 255;
+	}
+
+	// Same truncation as Analog_Voltage_to_Digital
+	return (uint8_t)(((uint32_t)counts * 255) / ADC_FULL_SCALE);
+}
+
+/**
+ * @brief Reads the filtered result of PE1 (light sensor) without waiting.
+ *
+ * @param analog_value_buffer Array to store the sampled value
+ */
+void ADC_Sample(double analog_value_buffer[])
+{
+	PROFILE_BEGIN(PROFILE_ADC_SAMPLE);
 
 	// Convert to voltage and store in buffer
-	analog_value_buffer[1] = (result_pe1 * 3.3) / 4095.0; // PE1 - Light Sensor
+	analog_value_buffer[1] = (ADC_Get_Filtered() * 3.3) / 4095.0; // PE1 - Light Sensor
 
-	// Clear interrupt flag
-	ADC0->ISC = 0x01; // Clear SS0 interrupt by writing 1 to bit 0
+	PROFILE_END(PROFILE_ADC_SAMPLE);
 }
 int Analog_Voltage_to_Digital(double voltage)
 {
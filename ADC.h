@@ -9,9 +9,17 @@
  * light sensor that are connected on the EduBase board. ADC Module 0
  * is configured to sample the potentiometer first and the light sensor after.
  *
- * After the light sensor is sampled, an interrupt signal is set to 
- * indicate that the sampling sequence has ended. After the conversion
- * results have been read from the corresponding FIFO, the interrupt is cleared.
+ * Sample Sequencer 0 converts both channels each time Timer3A triggers it,
+ * with 16x hardware averaging. Its interrupt moves every light sensor
+ * result from the FIFO into a ring buffer and updates a low-pass filtered
+ * value, and keeps the latest potentiometer result, so reading either
+ * never waits for a conversion. The light sensor (ADC_Start) and the dial
+ * each ask for a rate, and Timer3A runs at the fastest one.
+ *
+ * Instead of the FIFO, the light sensor step can be routed to digital
+ * comparator 0 (ADC_Comparator_Start). The comparator then watches every
+ * result in hardware and only interrupts while the sensor is dark, so
+ * nothing runs while it is lit.
  *
  * The following pins are used:
  *  - Potentiometer   <-->  Tiva LaunchPad Pin PE2 (Channel 1)
@@ -20,32 +28,181 @@
  * @author Mario Hernandez
  *
  */
+#ifndef ADC_H
+#define ADC_H
 
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
 
+// Default conversion rate of the light sensor (100 Hz to 1 kHz)
+#define ADC_SAMPLE_RATE_HZ 100
+
+// Capacity of the ring buffer of raw results, a power of two
+#define ADC_RING_SIZE 32
+
+// Weight of a new result in the filtered value: 1 / 2^ADC_FILTER_SHIFT
+#define ADC_FILTER_SHIFT 2
+
+// Users of the shared sequence, each asking for its own rate
+typedef enum {
+    ADC_USER_LIGHT,
+    ADC_USER_DIAL,
+    ADC_USER_COUNT
+} ADC_User;
+
+// Reference voltage and full-scale result of the 12-bit converter
+#define ADC_VREF_MV    3300
+#define ADC_FULL_SCALE 4095
+
+// Converts between millivolts and raw results, rounded to nearest.
+// Use these on constants so thresholds are computed by the compiler
+#define ADC_MV_TO_COUNTS(mv)     ((((uint32_t)(mv) * ADC_FULL_SCALE) + (ADC_VREF_MV / 2)) / ADC_VREF_MV)
+#define ADC_COUNTS_TO_MV(counts) ((((uint32_t)(counts) * ADC_VREF_MV) + (ADC_FULL_SCALE / 2)) / ADC_FULL_SCALE)
+
+// Latest filtered reading of the light sensor
+typedef struct {
+    uint16_t light_raw;     // 0 to ADC_FULL_SCALE
+    uint16_t light_mv;      // 0 to ADC_VREF_MV
+} ADC_Reading;
+
 /**
- * @brief Initializes ADC0 and configures it to sample from PE1 (AIN2).
+ * @brief Initializes ADC0 and configures it to sample from PE2 (AIN1) and PE1 (AIN2).
  *
- * Sets up GPIO Port E, enables analog input on PE1,
- * and configures Sample Sequencer 0 for single software-triggered sampling.
+ * Sets up GPIO Port E, enables analog input on PE1 and PE2, configures
+ * Sample Sequencer 0 for Timer3A-triggered sampling with an interrupt
+ * and sets up Timer3A at ADC_SAMPLE_RATE_HZ. Sampling is left stopped.
  */
 void ADC_Init(void);
 
 /**
- * @brief Samples the analog voltage from PE1 and stores it in a buffer.
+ * @brief Sets the rate one user needs. Timer3A runs at the fastest rate asked for.
+ *
+ * @param user    The user of the sequence.
+ * @param rate_hz Conversions per second, or 0 when the user no longer needs any.
+ */
+void ADC_Set_Rate(ADC_User user, uint32_t rate_hz);
+
+/**
+ * @brief Starts sampling the light sensor at the given rate.
+ *
+ * The filter restarts from the first new result.
+ *
+ * @param rate_hz Conversions per second.
+ */
+void ADC_Start(uint32_t rate_hz);
+
+/**
+ * @brief Returns 1 if the ring buffer holds results that have not been read.
+ */
+uint8_t ADC_Has_Samples(void);
+
+/**
+ * @brief Returns 1 if a potentiometer result arrived since the last ADC_Take_Potentiometer.
+ */
+uint8_t ADC_Potentiometer_Has_New(void);
+
+/**
+ * @brief Reads the latest potentiometer result if it is new.
+ *
+ * @param counts Receives the result (0 to 4095).
+ * @return 1 if a new result was read, 0 otherwise.
+ */
+uint8_t ADC_Take_Potentiometer(uint16_t* counts);
+
+/**
+ * @brief Returns the filtered light sensor result (0 to 4095).
+ */
+uint16_t ADC_Get_Filtered(void);
+
+/**
+ * @brief Removes up to max_count raw results from the ring buffer, oldest first.
+ *
+ * @param samples   Destination for the results (0 to 4095).
+ * @param max_count Capacity of samples.
+ * @return Number of results copied.
+ */
+uint8_t ADC_Read_Samples(uint16_t samples[], uint8_t max_count);
+
+/**
+ * @brief Returns the number of results lost because the ring buffer or the FIFO was full.
+ */
+uint32_t ADC_Get_Overrun_Count(void);
+
+/**
+ * @brief Routes the light sensor to digital comparator 0 and watches for it being covered.
+ *
+ * Results below low_counts enter the low band; the comparator keeps
+ * interrupting (hysteresis) until a result reaches high_counts. A single
+ * event is raised after min_count results in a row without reaching
+ * high_counts, then the comparator stays quiet until restarted. Results no
+ * longer reach the ring buffer or the filtered value, and the potentiometer
+ * is not read either. Sampling must be started with ADC_Start.
  *
- * Initiates a conversion, waits for completion, and stores the result
- * as a voltage (0.0 to .6 V) in the specified index of the provided buffer.
+ * @param low_counts  Enter threshold (0 to 4095).
+ * @param high_counts Exit threshold, at or above low_counts.
+ * @param min_count   Results in a row that make an event.
+ */
+void ADC_Comparator_Start(uint16_t low_counts, uint16_t high_counts, uint16_t min_count);
+
+/**
+ * @brief Turns the comparator off and sends results to the ring buffer again.
+ */
+void ADC_Comparator_Stop(void);
+
+/**
+ * @brief Returns 1 if a comparator event has not been taken yet.
+ */
+uint8_t ADC_Comparator_Has_Event(void);
+
+/**
+ * @brief Returns 1 once after the comparator saw min_count covered results in a row.
+ */
+uint8_t ADC_Take_Comparator_Event(void);
+
+/**
+ * @brief Reads the filtered light sensor result in counts and millivolts.
+ *
+ * Does not start a conversion or wait. Uses integer math only.
+ *
+ * @param reading Receives the reading.
+ */
+void ADC_Read(ADC_Reading* reading);
+
+/**
+ * @brief Scales a raw result (0 to 4095) to an 8-bit value (0 to 255).
+ */
+uint8_t ADC_Counts_To_8bit(uint16_t counts);
+
+/**
+ * @brief Stores the filtered light sensor voltage in a buffer.
+ *
+ * Does not start a conversion or wait: the latest filtered value is
+ * converted to a voltage (0.0 to 3.3 V) and stored in index 1.
+ *
+ * Kept for existing callers. It pulls in the software double-precision
+ * routines, so new code should use ADC_Read.
  *
  * @param analog_value_buffer Pointer to a double array; result is stored at index 1.
  */
 void ADC_Sample(double analog_value_buffer[]);
 
+/**
+ * @brief ADC0 Sample Sequencer 0 interrupt handler.
+ *
+ * Moves the FIFO into the ring buffer and updates the filtered value,
+ * and counts the digital comparator interrupts.
+ */
+void ADC0SS0_Handler(void);
+
 /**
  * @brief Converts a floating-point voltage to an 8-bit digital value (0255).
  *
+ * Kept for existing callers; ADC_Counts_To_8bit does the same on raw
+ * results without double-precision math.
+ *
  * @param voltage Voltage value between 0.0 and .6
  * @return Integer between 0 and 255 representing the scaled digital value
  */
 int Analog_Voltage_to_Digital(double voltage);
+
+#endif
@@ -1,20 +1,28 @@
 // Alarm.c
 #include "TM4C123GH6PM.h"
 #include "Alarm.h"
+#include "GPIO_HAL.h"
+
+// Buzzer (PB6) and alarm LED (PF1) pin groups. Clock_Check_Alarm drives these
+// from the clock interrupt while main writes the LEDs on Port B, so they are
+// written through the masked DATA addresses instead of read-modify-write
+static const GPIO_Pin_Group buzzer_pin = GPIO_PIN_GROUP(GPIO_PORTB_BASE, (1 << 6));
+static const GPIO_Pin_Group alarm_led_pin = GPIO_PIN_GROUP(GPIO_PORTF_BASE, (1 << 1));
 
 // Initialize the alarm by setting up the buzzer on PB6 and an LED on PF1.
 void Alarm_Init(void) {
+    GPIO_Bus_Init();
     SYSCTL->RCGCGPIO |= 0x22;
     while ((SYSCTL->PRGPIO & 0x22) != 0x22) {}
 
-    GPIOB->DIR |= (1 << 6);
-    GPIOB->DEN |= (1 << 6);
+    GPIO_PORTB->DIR |= (1 << 6);
+    GPIO_PORTB->DEN |= (1 << 6);
 
-    GPIOF->DIR |= (1 << 1);
-    GPIOF->DEN |= (1 << 1);
+    GPIO_PORTF->DIR |= (1 << 1);
+    GPIO_PORTF->DEN |= (1 << 1);
 
-    GPIOB->DATA &= ~(1 << 6);
-    GPIOF->DATA &= ~(1 << 1);
+    GPIO_Pin_Group_Clear(&buzzer_pin);
+    GPIO_Pin_Group_Clear(&alarm_led_pin);
 }
 
 void Alarm_On(void)
@@ -22,22 +30,22 @@ void Alarm_On(void)
     SYSCTL->RCGCGPIO |= (1 << 1) | (1 << 5);
     while ((SYSCTL->PRGPIO & ((1 << 1) | (1 << 5))) == 0);
 
-    GPIOB->DIR |= (1 << 6);
-    GPIOB->DEN |= (1 << 6);
+    GPIO_PORTB->DIR |= (1 << 6);
+    GPIO_PORTB->DEN |= (1 << 6);
 
-    GPIOF->DIR |= (1 << 1);
-    GPIOF->DEN |= (1 << 1);
+    GPIO_PORTF->DIR |= (1 << 1);
+    GPIO_PORTF->DEN |= (1 << 1);
 
-    GPIOB->DATA |= (1 << 6);
-    GPIOF->DATA |= (1 << 1);
+    GPIO_Pin_Group_Set(&buzzer_pin);
+    GPIO_Pin_Group_Set(&alarm_led_pin);
 }
 
 void Alarm_Off(void) {
-    GPIOB->DATA &= ~(1 << 6);
-    GPIOF->DATA &= ~(1 << 1);
+    GPIO_Pin_Group_Clear(&buzzer_pin);
+    GPIO_Pin_Group_Clear(&alarm_led_pin);
 }
 
 void Alarm_Toggle(void) {
-    GPIOB->DATA ^= (1 << 6);
-    GPIOF->DATA ^= (1 << 1);
+    GPIO_Pin_Group_Toggle(&buzzer_pin);
+    GPIO_Pin_Group_Toggle(&alarm_led_pin);
 }
@@ -1,63 +1,272 @@
 #include "TM4C123GH6PM.h"
 #include "Buttons.h"
+#include "Timer.h"
+#include "GPIO_HAL.h"
+#include "Profile.h"
 #include "SysTick_Delay.h"
 
-// Internal state to track most recent button press
-static volatile ButtonEvent current_event = BUTTON_NONE;
+// PD3 = physical SW2, PD2 = SW3, PD1 = SW4, PD0 = SW5
+#define BUTTON_PINS 0x0F
+#define BUTTON_PIN(button) (1 << (3 - (button)))
+
+// Default debounce windows in ms, as long as the old in-ISR delays
+static uint8_t debounce_window[BUTTON_COUNT] = { 35, 35, 25, 30 };
+
+// Integrating counters (0 = released, debounce_window = pressed) and debounced states
+static uint8_t debounce_count[BUTTON_COUNT];
+static uint8_t button_down = 0;     // One bit per button
+
+// Auto-repeat: interval of each acceleration level and the repeats spent in it
+typedef struct {
+    uint16_t interval_ms;
+    uint8_t repeats;        // 0 for the last level
+} Button_Repeat_Level;
+
+static const Button_Repeat_Level repeat_levels[BUTTONS_REPEAT_LEVELS] = {
+    { 250, 4  },    // 4 Hz for one second
+    { 100, 10 },    // 10 Hz for one second
+    { 50,  0  },    // 20 Hz from then on
+};
+
+static uint8_t repeat_enabled = (1 << BUTTON_SW2) | (1 << BUTTON_SW3);
+static uint16_t repeat_countdown[BUTTON_COUNT];    // ms until the next repeat
+static uint8_t repeat_level[BUTTON_COUNT];
+static uint8_t repeat_count[BUTTON_COUNT];         // Repeats in the current level
+
+_Static_assert((BUTTONS_QUEUE_SIZE & (BUTTONS_QUEUE_SIZE - 1)) == 0, "BUTTONS_QUEUE_SIZE must be a power of two");
+
+// Event queue. Only the Timer4A interrupt moves the head and only main moves the tail,
+// so neither side needs to mask interrupts
+static Button_Record event_queue[BUTTONS_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0;
+static volatile uint32_t queue_tail = 0;
+static volatile uint32_t overflow_count = 0;
+
+// Producer side, called from the Timer4A interrupt
+static void Buttons_Post(uint8_t button, Button_Action action, uint8_t level)
+{
+    uint32_t head = queue_head;
+
+    if ((head - queue_tail) >= BUTTONS_QUEUE_SIZE)
+    {
+        overflow_count++;
+        return;
+    }
+
+    Button_Record* record = &event_queue[head & (BUTTONS_QUEUE_SIZE - 1)];
+    record->time_us = SysTick_Now_us();
+    record->button = button;
+    record->action = (uint8_t)action;
+    record->level = level;
+
+    // The record must be complete before main can see it
+    __DMB();
+    queue_head = head + 1;
+}
 
 void Buttons_Init(void)
 {
+    GPIO_Bus_Init();                    // Select GPIO bus apertures
     SYSCTL->RCGCGPIO |= 0x08;           // Enable Port D clock
     while ((SYSCTL->PRGPIO & 0x08) == 0);
 
     // Unlock PD3 for use (SW5)
-    GPIOD->LOCK = 0x4C4F434B;           // Unlock PD3
-    GPIOD->CR   |= (1 << 3);            // Allow changes to PD3
+    GPIO_PORTD->LOCK = 0x4C4F434B;           // Unlock PD3
+    GPIO_PORTD->CR   |= (1 << 3);            // Allow changes to PD3
+
+    GPIO_PORTD->DIR  &= ~0x0F;               // PD0PD3 as input
+    GPIO_PORTD->DEN  |= 0x0F;                // Digital enable
+    GPIO_PORTD->IS   &= ~0x0F;               // Edge-sensitive
+    GPIO_PORTD->IBE  |= 0x0F;                // Both edges, so releases start sampling too
+    GPIO_PORTD->ICR   = 0x0F;                // Clear interrupts
+    GPIO_PORTD->IM   |= 0x0F;                // Enable interrupt
+
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    {
+        debounce_count[i] = 0;
+    }
+    button_down = 0;
+    queue_head = 0;
+    queue_tail = 0;
+    overflow_count = 0;
 
-    GPIOD->DIR  &= ~0x0F;               // PD0PD3 as input
-    GPIOD->DEN  |= 0x0F;                // Digital enable
-    GPIOD->IS   &= ~0x0F;               // Edge-sensitive
-    GPIOD->IEV  |= 0x0F;                // Rising edge
-    GPIOD->ICR   = 0x0F;                // Clear interrupts
-    GPIOD->IM   |= 0x0F;                // Enable interrupt
+    Timer4A_Init_1kHz();
 
     NVIC_EnableIRQ(GPIOD_IRQn);
 }
 
-void GPIOD_Handler(void)
+void Buttons_Set_Debounce_ms(Button_Id button, uint8_t window_ms)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    debounce_window[button] = (window_ms == 0) ? 1 : window_ms;
+
+    // Keep the counter on the debounced state's end of the new range
+    debounce_count[button] = (button_down & (1 << button)) ? debounce_window[button] : 0;
+
+    __set_PRIMASK(primask);
+}
+
+void Buttons_Set_Repeat(Button_Id button, bool enabled)
 {
-    if (GPIOD->RIS & (1 << 3)) {
-        GPIOD->ICR = (1 << 3);
-        current_event = BUTTON_SW2_PRESSED; // PD3 = physical SW2
-				SysTick_Delay1ms(35); // debounce delay
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (enabled)
+    {
+        repeat_enabled |= (1 << button);
     }
-    else if (GPIOD->RIS & (1 << 2)) {
-        GPIOD->ICR = (1 << 2);
-        current_event = BUTTON_SW3_PRESSED; // PD2 = physical SW3
-			SysTick_Delay1ms(35); // debounce delay
+    else
+    {
+        repeat_enabled &= ~(1 << button);
     }
-    else if (GPIOD->RIS & (1 << 1)) {
-        GPIOD->ICR = (1 << 1);
-        current_event = BUTTON_SW4_PRESSED; // PD1 = physical SW4
-				SysTick_Delay1ms(25); // debounce delay
+
+    __set_PRIMASK(primask);
+}
+
+// Counts one millisecond of a held button and posts a repeat when it is due
+static void Buttons_Repeat(uint8_t button)
+{
+    if (--repeat_countdown[button] != 0)
+    {
+        return;
     }
-    else if (GPIOD->RIS & (1 << 0)) {
-        GPIOD->ICR = (1 << 0);
-        current_event = BUTTON_SW5_PRESSED; // PD0 = physical SW5
-				SysTick_Delay1ms(30); // debounce delay			(unused)
+
+    uint8_t level = repeat_level[button];
+    Buttons_Post(button, BUTTON_ACTION_REPEAT, level);
+
+    // Move to the next level once this one has used up its repeats
+    if ((repeat_levels[level].repeats != 0) &&
+        (++repeat_count[button] >= repeat_levels[level].repeats))
+    {
+        level++;
+        repeat_level[button] = level;
+        repeat_count[button] = 0;
     }
+    repeat_countdown[button] = repeat_levels[level].interval_ms;
 }
 
+bool Button_Is_Down(Button_Id button)
+{
+    return (button_down & (1 << button)) != 0;
+}
+
+// An edge only starts the sampling timer, which reads every pin at once.
+// Bounce edges while it runs do nothing. Both interrupts share a priority, so
+// an edge cannot slip in between the last sample and the timer being stopped
+void GPIOD_Handler(void)
+{
+    PROFILE_BEGIN(PROFILE_GPIOD_ISR);
+
+    // Clear every pending pin in one pass
+    GPIO_PORTD->ICR = GPIO_PORTD->MIS & BUTTON_PINS;
+    Timer4A_Start();
+
+    PROFILE_END(PROFILE_GPIOD_ISR);
+}
+
+void Buttons_Sample(void)
+{
+    uint8_t pins = GPIO_PORTD->DATA & BUTTON_PINS;
+    uint8_t stable = 1;
+
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    {
+        uint8_t mask = (1 << i);
+        uint8_t level = (pins & BUTTON_PIN(i)) ? 1 : 0;
+        uint8_t count = debounce_count[i];
+
+        // Integrate one step toward the sampled level
+        if (level && (count < debounce_window[i]))
+        {
+            count++;
+        }
+        else if (!level && (count > 0))
+        {
+            count--;
+        }
+        debounce_count[i] = count;
+
+        // The state only changes at the ends of the range
+        if ((count == debounce_window[i]) && !(button_down & mask))
+        {
+            button_down |= mask;
+            Buttons_Post(i, BUTTON_ACTION_PRESS, 0);
 
+            repeat_countdown[i] = BUTTONS_REPEAT_DELAY_MS;
+            repeat_level[i] = 0;
+            repeat_count[i] = 0;
+        }
+        else if ((count == 0) && (button_down & mask))
+        {
+            button_down &= ~mask;
+            Buttons_Post(i, BUTTON_ACTION_RELEASE, 0);
+        }
+
+        else if ((button_down & mask) && (repeat_enabled & mask))
+        {
+            Buttons_Repeat(i);
+        }
+
+        // A held button with auto-repeat keeps the sampling running
+        if ((level ? (count != debounce_window[i]) : (count != 0)) ||
+            ((button_down & mask) && (repeat_enabled & mask)))
+        {
+            stable = 0;
+        }
+    }
+
+    // Nothing left to debounce until the next edge
+    if (stable)
+    {
+        Timer4A_Stop();
+    }
+}
 
 bool Button_HasEvent(void)
 {
-    return current_event != BUTTON_NONE;
+    return queue_head != queue_tail;
+}
+
+bool Button_Read_Record(Button_Record* record)
+{
+    uint32_t tail = queue_tail;
+
+    if (queue_head == tail)
+    {
+        return false;
+    }
+
+    // Copy the record before the slot is handed back to the interrupt
+    __DMB();
+    *record = event_queue[tail & (BUTTONS_QUEUE_SIZE - 1)];
+    __DMB();
+    queue_tail = tail + 1;
+    return true;
 }
 
 ButtonEvent Button_GetEvent(void)
 {
-    ButtonEvent temp = current_event;
-    current_event = BUTTON_NONE;
-    return temp;
+    Button_Record record;
+
+    if (!Button_Read_Record(&record))
+    {
+        return BUTTON_NONE;
+    }
+
+    switch (record.action)
+    {
+        case BUTTON_ACTION_PRESS:
+            return (ButtonEvent)(BUTTON_SW2_PRESSED + record.button);
+        case BUTTON_ACTION_REPEAT:
+            return (ButtonEvent)(BUTTON_SW2_REPEAT + record.button);
+        default:
+            return (ButtonEvent)(BUTTON_SW2_RELEASED + record.button);
+    }
+}
+
+uint32_t Button_Get_Overflow_Count(void)
+{
+    return overflow_count;
 }
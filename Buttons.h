@@ -3,14 +3,40 @@
  *
  * @brief Interface for handling button inputs on the EduBase Board (SW2SW5).
  *
- * This module configures GPIO Port D (PD0PD3) as input buttons and uses
- * interrupts to detect button presses. It tracks button events with software
- * debouncing and allows polling the most recent press.
+ * This module configures GPIO Port D (PD0PD3) as input buttons. An edge on
+ * any button starts a 1 kHz sampling timer (Timer4A), and an integrating
+ * counter per button debounces the samples: the counter moves toward the
+ * sampled level by one step per sample, and the button only changes state
+ * when its counter reaches the end of its range. Each button has its own
+ * debounce window. The timer stops again once every button is stable, and
+ * no interrupt handler waits.
+ *
+ * A button held down with auto-repeat enabled produces repeat events,
+ * first at 4 Hz, then at 10 Hz and finally at 20 Hz. Each repeat carries
+ * its acceleration level so the caller can take larger steps as well.
+ *
+ * Press, repeat and release events are timestamped and kept in a lock-free
+ * single-producer/single-consumer queue: the Timer4A interrupt writes, the
+ * main loop reads. Events that arrive while the queue is full are dropped
+ * and counted.
  */
 #ifndef BUTTONS_H
 #define BUTTONS_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+// Button sampling rate (Timer4A)
+#define BUTTONS_SAMPLE_HZ 1000
+
+// Capacity of the event queue, a power of two
+#define BUTTONS_QUEUE_SIZE 16
+
+// Hold time before the first repeat
+#define BUTTONS_REPEAT_DELAY_MS 500
+
+// Number of auto-repeat acceleration levels
+#define BUTTONS_REPEAT_LEVELS 3
 
 // Enum to represent button events
 typedef enum {
@@ -18,32 +44,103 @@ typedef enum {
     BUTTON_SW2_PRESSED,
     BUTTON_SW3_PRESSED,
     BUTTON_SW4_PRESSED,
-    BUTTON_SW5_PRESSED
+    BUTTON_SW5_PRESSED,
+    BUTTON_SW2_RELEASED,
+    BUTTON_SW3_RELEASED,
+    BUTTON_SW4_RELEASED,
+    BUTTON_SW5_RELEASED,
+    BUTTON_SW2_REPEAT,
+    BUTTON_SW3_REPEAT,
+    BUTTON_SW4_REPEAT,
+    BUTTON_SW5_REPEAT
 } ButtonEvent;
 
+// Buttons, in the order of their events
+typedef enum {
+    BUTTON_SW2,
+    BUTTON_SW3,
+    BUTTON_SW4,
+    BUTTON_SW5,
+    BUTTON_COUNT
+} Button_Id;
+
+typedef enum {
+    BUTTON_ACTION_RELEASE,
+    BUTTON_ACTION_PRESS,
+    BUTTON_ACTION_REPEAT
+} Button_Action;
+
+// A debounced press or release, or an auto-repeat of a held button
+typedef struct {
+    uint64_t time_us;   // SysTick time of the event
+    uint8_t button;     // Button_Id
+    uint8_t action;     // Button_Action
+    uint8_t level;      // Acceleration level of a repeat (0 to BUTTONS_REPEAT_LEVELS - 1), 0 otherwise
+} Button_Record;
+
 
 /**
  * @brief Initializes the GPIO for EduBase buttons (PD0PD3) and enables interrupts.
  *
  * Unlocks PD3 as required, configures all pins as inputs with digital enable,
- * and sets up interrupt detection on rising edges.
+ * sets up interrupt detection on both edges and configures the sampling timer.
  */
 void Buttons_Init(void);
 
 /**
- * @brief Returns whether any button press event has been registered.
+ * @brief Sets the debounce window of a button.
+ *
+ * The button changes state once the samples at the new level outnumber the
+ * samples at the old level by the window.
+ *
+ * @param button    The button.
+ * @param window_ms Debounce window in milliseconds (1255).
+ */
+void Buttons_Set_Debounce_ms(Button_Id button, uint8_t window_ms);
+
+/**
+ * @brief Enables or disables auto-repeat for a button. Enabled for SW2 and SW3 by default.
+ */
+void Buttons_Set_Repeat(Button_Id button, bool enabled);
+
+/**
+ * @brief Returns whether a button is held down, after debouncing.
+ */
+bool Button_Is_Down(Button_Id button);
+
+/**
+ * @brief Samples and debounces the buttons. Called from the Timer4A interrupt.
+ */
+void Buttons_Sample(void);
+
+/**
+ * @brief Returns whether any button press, repeat or release event has been registered.
  *
  * @return true if a button event is pending, false otherwise.
  */
 bool Button_HasEvent(void);
 
 /**
- * @brief Returns and clears the most recent button press event.
+ * @brief Removes the oldest button event from the queue.
  *
- * After calling this, the stored event is reset to BUTTON_NONE.
+ * Events are returned in the order they happened. After the last event is
+ * read, BUTTON_NONE is returned.
  *
- * @return The last button press event (e.g., BUTTON_SW3_PRESSED).
+ * @return The button event (e.g., BUTTON_SW3_PRESSED).
  */
 ButtonEvent Button_GetEvent(void);
 
+/**
+ * @brief Removes the oldest button event from the queue with its timestamp.
+ *
+ * @param record Receives the event.
+ * @return true if an event was read, false if the queue was empty.
+ */
+bool Button_Read_Record(Button_Record* record);
+
+/**
+ * @brief Returns the number of events dropped because the queue was full.
+ */
+uint32_t Button_Get_Overflow_Count(void);
+
 #endif
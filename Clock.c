@@ -5,20 +5,61 @@
  * This module manages the internal time (HH:MM:SS), allows manual time setting,
  * and compares the current time to a user-set alarm. When the time matches,
  * the alarm is activated for 5 seconds via LEDs and buzzer.
+ *
+ * The time is kept as seconds since midnight by one of two backends,
+ * selected with CLOCK_BACKEND (see Clock.h):
+ *  - Timer0A: a counter advanced by the 1 Hz Timer0A interrupt
+ *  - HIB RTC: the Hibernation module's RTC, read when the time is needed.
+ *    The match register is set to the next second so the seconds display,
+ *    the seconds software timers and the alarm check still run every second.
+ *    The alarm settings are kept in the battery-backed DATA words.
+ *
+ * Either time base can be trimmed by a few hundred ppm. The trim is
+ * measured in calibration mode against a second oscillator: Timer0A runs
+ * from the main crystal and is measured against the RTC, the RTC runs from
+ * the 32.768 kHz crystal and is measured against SysTick. The trim is kept
+ * in the battery-backed DATA words with both backends.
  */
 
 #include "Clock.h"
 #include "GPIO.h"
 #include "Alarm.h"
 #include "EduBase_LCD.h"
-#include <stdio.h>
+#include "Soft_Timer.h"
+#include "Hib_RTC.h"
+#include "TM4C123GH6PM.h"
+#include <stddef.h>
 
-// ==============================
-// Timekeeping Variables
-// ==============================
-static int hour = 0;
-static int minute = 0;
-static int second = 0;
+#if CLOCK_BACKEND == CLOCK_BACKEND_HIB_RTC
+#include "SysTick_Delay.h"
+#else
+#include "Timer.h"
+#endif
+
+#define ALARM_ACTIVE_SECONDS 5
+
+#define SECONDS_PER_DAY 86400UL
+
+// Battery-backed DATA words
+#define CLOCK_DATA_MAGIC_WORD       0   // CLOCK_DATA_MAGIC once the time has been set
+#define CLOCK_DATA_ALARM_WORD       1   // Alarm time and enable bit
+#define CLOCK_DATA_TRIM_WORD        2   // Trim in ppb
+#define CLOCK_DATA_TRIM_CHECK_WORD  3   // Inverted trim, marks the trim as valid
+#define CLOCK_DATA_MAGIC            0x434C4B31UL
+
+#define CLOCK_DATA_ALARM_ENABLED 0x01000000UL
+
+// Both time bases are near their nominal rate; larger trims are measurement errors
+#define CLOCK_TRIM_LIMIT_PPB 500000L
+
+// Largest calibration difference whose product with 1e9 leaves room for rounding
+#define CLOCK_CALIBRATION_DIFFERENCE_LIMIT ((INT64_MAX / 2) / 1000000000LL)
+
+// Timestamps of the clock's time base and the calibration reference, taken together
+typedef struct {
+    uint64_t local;
+    uint64_t reference;
+} Clock_Calibration_Sample;
 
 // ==============================
 // Alarm Time Variables (shared with main)
@@ -31,106 +72,448 @@ int alarm_second = 0;
 // Internal State
 // ==============================
 static int alarm_enabled = 1;
-static int alarm_active_counter = 0;  // Tracks how long alarm stays on
+static uint8_t time_valid = 0;                  // Set once the time is known
+static volatile uint8_t alarm_event = 0;        // Set when the alarm goes off
+static int32_t trim_ppb = 0;
+static Soft_Timer alarm_active_timer; // Turns the alarm off after ALARM_ACTIVE_SECONDS
 volatile int update_display_flag = 0; // Signals main to update LCD
 
-// ==============================
-// Initialization
-// ==============================
-void Clock_Init(void)
+// Calibration state, sampled on every clock tick while running
+static volatile uint8_t calibration_running = 0;
+static volatile uint8_t calibration_start_pending = 0;
+static Clock_Calibration_Sample calibration_start;
+static Clock_Calibration_Sample calibration_last;
+
+static void Clock_Calibration_Take_Sample(Clock_Calibration_Sample* sample);
+
+// Called from the tick interrupt
+static void Clock_Calibration_Record(void)
 {
-    hour = 0;
-    minute = 0;
-    second = 0;
-    update_display_flag = 1; // Force display on startup
+    if (!calibration_running)
+    {
+        return;
+    }
+
+    Clock_Calibration_Take_Sample(&calibration_last);
+    if (calibration_start_pending)
+    {
+        calibration_start = calibration_last;
+        calibration_start_pending = 0;
+    }
 }
 
+static void Clock_Alarm_Active_Expired(void* context)
+{
+    (void)context;
+    Alarm_Off();
+    EduBase_LEDs_Output(0x00);
+}
+
+// Turns the alarm on if it is set to the given second of the day
+static void Clock_Check_Alarm_At(uint32_t time_of_day)
+{
+    uint32_t alarm_time = (uint32_t)alarm_hour * 3600 + (uint32_t)alarm_minute * 60 + (uint32_t)alarm_second;
+
+    if (alarm_enabled && (time_of_day == alarm_time))
+    {
+        EduBase_LEDs_Output(0x0F);        // Turn on all LEDs
+        Alarm_On();                       // onboard LED
+        alarm_event = 1;
+
+        // Alarm stays on for 5 seconds
+        Soft_Timer_Start(&alarm_active_timer, ALARM_ACTIVE_SECONDS, 0);
+    }
+}
+
+#if CLOCK_BACKEND == CLOCK_BACKEND_HIB_RTC
+
 // ==============================
-// Manual Time Setting Function
+// HIB RTC Backend
 // ==============================
+
+// Calibration: RTC subsecond counts against SysTick cycles (main crystal)
+#define CLOCK_CALIBRATION_LOCAL_HZ      HIB_RTC_SUBSECONDS_HZ
+#define CLOCK_CALIBRATION_REFERENCE_HZ  SYSTICK_CLOCK_HZ
+
+// Last RTC second counted by Clock_Tick
+static uint32_t ticked_seconds = 0;
+
+static uint32_t Clock_Now(void)
+{
+    return Hib_RTC_Read(NULL) % SECONDS_PER_DAY;
+}
+
+static void Clock_Save_Alarm(void)
+{
+    uint32_t word = ((uint32_t)alarm_hour << 16) | ((uint32_t)alarm_minute << 8) | (uint32_t)alarm_second;
+
+    if (alarm_enabled)
+    {
+        word |= CLOCK_DATA_ALARM_ENABLED;
+    }
+    Hib_RTC_Write_Data(CLOCK_DATA_ALARM_WORD, word);
+}
+
+static void Clock_Calibration_Take_Sample(Clock_Calibration_Sample* sample)
+{
+    uint32_t subseconds;
+    uint32_t seconds = Hib_RTC_Read(&subseconds);
+
+    sample->reference = SysTick_Now_Cycles();
+    sample->local = (uint64_t)seconds * HIB_RTC_SUBSECONDS_HZ + subseconds;
+}
+
+static void Clock_Apply_Trim(int32_t trim)
+{
+    Hib_RTC_Set_Trim_ppb(trim);
+}
+
+static void Clock_Backend_Init(void)
+{
+    uint8_t rtc_running = Hib_RTC_Init();
+
+    time_valid = rtc_running && (Hib_RTC_Read_Data(CLOCK_DATA_MAGIC_WORD) == CLOCK_DATA_MAGIC);
+
+    if (time_valid)
+    {
+        uint32_t word = Hib_RTC_Read_Data(CLOCK_DATA_ALARM_WORD);
+        alarm_hour = (int)((word >> 16) & 0xFF) % 24;
+        alarm_minute = (int)((word >> 8) & 0xFF) % 60;
+        alarm_second = (int)(word & 0xFF) % 60;
+        alarm_enabled = (word & CLOCK_DATA_ALARM_ENABLED) ? 1 : 0;
+    }
+    else
+    {
+        Hib_RTC_Write_Data(CLOCK_DATA_MAGIC_WORD, 0);
+        Hib_RTC_Load(0);
+    }
+}
+
+void Clock_Start(void)
+{
+    __disable_irq();
+    ticked_seconds = Hib_RTC_Read(NULL);
+    Hib_RTC_Set_Match(ticked_seconds + 1);
+    __enable_irq();
+
+    Hib_RTC_Enable_Match_Interrupt();
+}
+
 void Clock_Set_Time(int h, int m, int s)
 {
-    hour = h % 24;
-    minute = m % 60;
-    second = s % 60;
+    uint32_t seconds = (uint32_t)(h % 24) * 3600 + (uint32_t)(m % 60) * 60 + (uint32_t)(s % 60);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    Hib_RTC_Load(seconds);
+    ticked_seconds = seconds;
+    Hib_RTC_Set_Match(seconds + 1);
+
+    // The RTC jumped, so a running calibration has nothing to measure against
+    calibration_running = 0;
+
+    __set_PRIMASK(primask);
+
+    Hib_RTC_Write_Data(CLOCK_DATA_MAGIC_WORD, CLOCK_DATA_MAGIC);
+    Clock_Save_Alarm();
+    time_valid = 1;
     update_display_flag = 1; // Trigger LCD update
 }
 
+void Clock_Tick(void)
+{
+    while (1)
+    {
+        uint32_t now = Hib_RTC_Read(NULL);
+
+        // Count every second since the last tick, so a late interrupt skips no alarm
+        while (ticked_seconds != now)
+        {
+            ticked_seconds++;
+            Soft_Timer_Tick(SOFT_TIMER_DOMAIN_SECONDS);
+            Clock_Check_Alarm_At(ticked_seconds % SECONDS_PER_DAY);
+        }
+        Clock_Calibration_Record();
+
+        // The match only fires on equality: if the RTC has already moved on, count again
+        Hib_RTC_Set_Match(now + 1);
+        if (Hib_RTC_Read(NULL) == now)
+        {
+            break;
+        }
+    }
+
+    update_display_flag = 1;       // Notify main to update LCD
+}
+
+#else
+
 // ==============================
-// Timekeeping Tick Function
+// Timer0A Backend
 // ==============================
+
+// Calibration: Timer0A ticks against RTC subsecond counts (32.768 kHz crystal)
+#define CLOCK_CALIBRATION_LOCAL_HZ      1
+#define CLOCK_CALIBRATION_REFERENCE_HZ  HIB_RTC_SUBSECONDS_HZ
+
+// Seconds since midnight, advanced by the Timer0A interrupt
+static volatile uint32_t time_of_day = 0;
+
+// Timer0A ticks since startup
+static uint32_t tick_count = 0;
+
+static uint32_t Clock_Now(void)
+{
+    return time_of_day;
+}
+
+static void Clock_Save_Alarm(void)
+{
+    // Only the trim survives a reset with this backend
+}
+
+static void Clock_Calibration_Take_Sample(Clock_Calibration_Sample* sample)
+{
+    uint32_t subseconds;
+    uint32_t seconds = Hib_RTC_Read(&subseconds);
+
+    sample->local = tick_count;
+    sample->reference = (uint64_t)seconds * HIB_RTC_SUBSECONDS_HZ + subseconds;
+}
+
+static void Clock_Apply_Trim(int32_t trim)
+{
+    Timer0A_Set_Trim_ppb(trim);
+}
+
+static void Clock_Backend_Init(void)
+{
+    // The RTC is the calibration reference and keeps the trim
+    Hib_RTC_Init();
+
+    time_of_day = 0;
+    time_valid = 0;
+}
+
+void Clock_Start(void)
+{
+    Timer0A_Init_1Hz();
+}
+
+void Clock_Set_Time(int h, int m, int s)
+{
+    time_of_day = (uint32_t)(h % 24) * 3600 + (uint32_t)(m % 60) * 60 + (uint32_t)(s % 60);
+    time_valid = 1;
+    update_display_flag = 1; // Trigger LCD update
+}
+
 void Clock_Tick(void)
 {
-    second++;
-    if (second >= 60)
+    uint32_t now = time_of_day + 1;
+
+    if (now >= SECONDS_PER_DAY)
     {
-        second = 0;
-        minute++;
+        now = 0;
     }
-    if (minute >= 60)
+    time_of_day = now;
+    tick_count++;
+
+    Clock_Check_Alarm_At(now);     // Check if alarm should go off
+    Clock_Calibration_Record();
+    update_display_flag = 1;       // Notify main to update LCD
+}
+
+#endif
+
+// ==============================
+// Initialization
+// ==============================
+void Clock_Init(void)
+{
+    Soft_Timer_Setup(&alarm_active_timer, SOFT_TIMER_DOMAIN_SECONDS,
+                     Clock_Alarm_Active_Expired, NULL);
+
+    Clock_Backend_Init();
+    alarm_event = 0;
+    calibration_running = 0;
+
+    // Restore the trim of the last calibration
+    uint32_t trim_word = Hib_RTC_Read_Data(CLOCK_DATA_TRIM_WORD);
+    if (Hib_RTC_Read_Data(CLOCK_DATA_TRIM_CHECK_WORD) == ~trim_word)
     {
-        minute = 0;
-        hour++;
+        trim_ppb = (int32_t)trim_word;
     }
-    if (hour >= 24)
+    else
     {
-        hour = 0;
+        trim_ppb = 0;
     }
+    Clock_Apply_Trim(trim_ppb);
 
-    Clock_Check_Alarm();           // Check if alarm should go off
-    update_display_flag = 1;       // Notify main to update LCD
+    update_display_flag = 1; // Force display on startup
+}
+
+int Clock_Is_Time_Valid(void)
+{
+    return time_valid;
 }
 
 // ==============================
-// Alarm Check and Timer Control
+// Alarm Check
 // ==============================
 void Clock_Check_Alarm(void)
 {
-    if (alarm_enabled &&
-        hour == alarm_hour &&
-        minute == alarm_minute &&
-        second == alarm_second)
+    Clock_Check_Alarm_At(Clock_Now());
+}
+
+int Clock_Take_Alarm_Event(void)
+{
+    if (!alarm_event)
     {
-        alarm_active_counter = 5;         // Alarm stays on for 5 seconds
-        EduBase_LEDs_Output(0x0F);        // Turn on all LEDs
-        Alarm_On();                       // onboard LED
+        return 0;
+    }
+
+    alarm_event = 0;
+    return 1;
+}
+
+// ==============================
+// Drift Trim and Calibration
+// ==============================
+void Clock_Set_Trim_ppb(int32_t trim)
+{
+    if (trim > CLOCK_TRIM_LIMIT_PPB)
+    {
+        trim = CLOCK_TRIM_LIMIT_PPB;
+    }
+    else if (trim < -CLOCK_TRIM_LIMIT_PPB)
+    {
+        trim = -CLOCK_TRIM_LIMIT_PPB;
     }
 
-    if (alarm_active_counter > 0)
+    trim_ppb = trim;
+    Clock_Apply_Trim(trim);
+
+    Hib_RTC_Write_Data(CLOCK_DATA_TRIM_WORD, (uint32_t)trim);
+    Hib_RTC_Write_Data(CLOCK_DATA_TRIM_CHECK_WORD, ~(uint32_t)trim);
+}
+
+int32_t Clock_Get_Trim_ppb(void)
+{
+    return trim_ppb;
+}
+
+void Clock_Calibration_Start(void)
+{
+    __disable_irq();
+    calibration_start_pending = 1;
+    calibration_running = 1;
+    __enable_irq();
+}
+
+int Clock_Calibration_Is_Running(void)
+{
+    return calibration_running;
+}
+
+int Clock_Calibration_Finish(int32_t* trim)
+{
+    __disable_irq();
+    uint8_t measured = calibration_running && !calibration_start_pending;
+    Clock_Calibration_Sample start = calibration_start;
+    Clock_Calibration_Sample end = calibration_last;
+    calibration_running = 0;
+    __enable_irq();
+
+    if (!measured || (end.local == start.local) || (end.reference == start.reference))
     {
-        alarm_active_counter--;
+        return 0;
+    }
 
-        if (alarm_active_counter == 0)
-        {
-            Alarm_Off();
-            EduBase_LEDs_Output(0x00);
-        }
+    // Rate of the trimmed time base relative to the reference, minus one, in ppb:
+    // (local * REFERENCE_HZ - reference * LOCAL_HZ) * 1e9 / (reference * LOCAL_HZ)
+    int64_t local_scaled = (int64_t)(end.local - start.local) * CLOCK_CALIBRATION_REFERENCE_HZ;
+    int64_t reference_scaled = (int64_t)(end.reference - start.reference) * CLOCK_CALIBRATION_LOCAL_HZ;
+    int64_t difference = local_scaled - reference_scaled;
+
+    // Drop low bits of both terms until the product and the rounding fit in 64 bits
+    while ((difference > CLOCK_CALIBRATION_DIFFERENCE_LIMIT) ||
+           (difference < -CLOCK_CALIBRATION_DIFFERENCE_LIMIT))
+    {
+        difference /= 2;
+        reference_scaled /= 2;
+    }
+
+    int64_t rounding = (difference >= 0) ? (reference_scaled / 2) : -(reference_scaled / 2);
+    int64_t error_ppb = ((difference * 1000000000LL) + rounding) / reference_scaled;
+
+    // A fast time base needs a larger trim; Clock_Set_Trim_ppb clamps the sum
+    int64_t new_trim = trim_ppb + error_ppb;
+    if (new_trim > CLOCK_TRIM_LIMIT_PPB)
+    {
+        new_trim = CLOCK_TRIM_LIMIT_PPB;
+    }
+    else if (new_trim < -CLOCK_TRIM_LIMIT_PPB)
+    {
+        new_trim = -CLOCK_TRIM_LIMIT_PPB;
     }
+    Clock_Set_Trim_ppb((int32_t)new_trim);
+
+    if (trim != NULL)
+    {
+        *trim = trim_ppb;
+    }
+    return 1;
 }
 
 // ==============================
 // Clock Getters
 // ==============================
-int Clock_Get_Hour(void)   { return hour; }
-int Clock_Get_Minute(void) { return minute; }
-int Clock_Get_Second(void) { return second; }
+int Clock_Get_Hour(void)   { return (int)(Clock_Now() / 3600); }
+int Clock_Get_Minute(void) { return (int)((Clock_Now() / 60) % 60); }
+int Clock_Get_Second(void) { return (int)(Clock_Now() % 60); }
+
+void Clock_Get_Time(int* h, int* m, int* s)
+{
+    // One reading, so a rollover cannot land between the fields
+    uint32_t now = Clock_Now();
+
+    *h = (int)(now / 3600);
+    *m = (int)((now / 60) % 60);
+    *s = (int)(now % 60);
+}
 
 // ==============================
 // Alarm Time Setters
 // ==============================
+void Clock_Set_Alarm(int h, int m)
+{
+    alarm_hour = h % 24;
+    alarm_minute = m % 60;
+    Clock_Save_Alarm();
+}
+
 void Alarm_Add_Hour(void)
 {
     alarm_hour = (alarm_hour + 1) % 24;
+    Clock_Save_Alarm();
 }
 
 void Alarm_Add_Minute(void)
 {
-    alarm_minute = (alarm_minute + 1) % 60;
+    Alarm_Add_Minutes(1);
+}
+
+void Alarm_Add_Minutes(int step)
+{
+    alarm_minute = ((alarm_minute / step + 1) * step) % 60;
+    Clock_Save_Alarm();
 }
 
 void Alarm_Add_Second(void)
 {
     alarm_second = (alarm_second + 1) % 60;
+    Clock_Save_Alarm();
 }
 
 // ==============================
@@ -139,6 +522,7 @@ void Alarm_Add_Second(void)
 void Clock_Toggle_Alarm(void)
 {
     alarm_enabled ^= 1; // Flip between 0 (OFF) and 1 (ON)
+    Clock_Save_Alarm();
 }
 
 int Clock_Alarm_Is_Enabled(void)
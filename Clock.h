@@ -6,10 +6,25 @@
  * This module manages the digital clock's current time (HH:MM:SS),
  * allows setting the time manually, and handles checking and triggering the alarm.
  * The clock updates once per second via a timer interrupt.
+ *
+ * The time is kept by one of two backends, selected at build time with
+ * CLOCK_BACKEND in the project's preprocessor symbols:
+ *  - CLOCK_BACKEND_TIMER0A: counted by the Timer0A interrupt; lost on reset
+ *  - CLOCK_BACKEND_HIB_RTC: kept by the Hibernation module RTC together with
+ *    the alarm settings, so both survive a reset (see Hib_RTC.h)
  */
 #ifndef CLOCK_H
 #define CLOCK_H
 
+#include <stdint.h>
+
+#define CLOCK_BACKEND_TIMER0A 0
+#define CLOCK_BACKEND_HIB_RTC 1
+
+#ifndef CLOCK_BACKEND
+#define CLOCK_BACKEND CLOCK_BACKEND_HIB_RTC
+#endif
+
 // External variables shared with main
 extern volatile int update_display_flag;
 extern int alarm_hour;
@@ -21,15 +36,31 @@ extern int alarm_second;
 /**
  * @brief Initializes the clock module.
  *
- * Resets the internal time to 00:00:00 and sets update flag.
+ * Resets the internal time to 00:00:00 and sets update flag. With the
+ * HIB RTC backend, a time set before the last reset is kept instead and
+ * the alarm settings are restored.
+ * Soft_Timer_Init must be called first.
  */
 void Clock_Init(void);
 
+/**
+ * @brief Starts the once-per-second clock interrupt.
+ *
+ * Timer0A with the Timer0A backend, the RTC match interrupt with the HIB RTC backend.
+ */
+void Clock_Start(void);
+
+/**
+ * @brief Returns 1 if the time has been set, either since startup or before the last reset.
+ */
+int Clock_Is_Time_Valid(void);
+
 /**
  * @brief Updates the clock time by 1 second.
  *
  * Increments the internal time variables and wraps as needed.
  * Also checks if the current time matches the alarm.
+ * With the HIB RTC backend, counts every RTC second since the last call.
  */
 void Clock_Tick(void);
 
@@ -37,10 +68,53 @@ void Clock_Tick(void);
  * @brief Checks if the current time matches the alarm time.
  *
  * If the alarm is enabled and the time matches, activates alarm for 5 seconds.
- * Handles countdown of how long the alarm stays active.
+ * A software timer turns it off again.
  */
 void Clock_Check_Alarm(void);
 
+/**
+ * @brief Returns 1 once for every time the alarm went off.
+ */
+int Clock_Take_Alarm_Event(void);
+
+// Drift trim and calibration----------------------
+
+/**
+ * @brief Sets the rate trim of the time base and keeps it across resets.
+ *
+ * The trim is clamped to +/-500 ppm.
+ *
+ * @param trim Oscillator error in parts per billion (1000 = 1 ppm); positive if it runs fast.
+ */
+void Clock_Set_Trim_ppb(int32_t trim);
+
+/**
+ * @brief Returns the rate trim in parts per billion.
+ */
+int32_t Clock_Get_Trim_ppb(void);
+
+/**
+ * @brief Starts measuring the time base against the calibration reference.
+ *
+ * Timer0A is measured against the Hibernation RTC, the RTC against SysTick.
+ * The measurement starts at the next tick and should run for an hour or more;
+ * its resolution is about 30 us divided by its length.
+ */
+void Clock_Calibration_Start(void);
+
+/**
+ * @brief Returns 1 while a calibration measurement is running.
+ */
+int Clock_Calibration_Is_Running(void);
+
+/**
+ * @brief Ends the measurement and corrects the trim by the measured error.
+ *
+ * @param trim Receives the new trim in parts per billion, or NULL.
+ * @return 1 if the trim was updated, 0 if not a single tick was measured.
+ */
+int Clock_Calibration_Finish(int32_t* trim);
+
 /**
  * @brief Sets the current time manually.
  *
@@ -67,7 +141,27 @@ int Clock_Get_Minute(void);
  */
 int Clock_Get_Second(void);
 
+/**
+ * @brief Reads the hour, minute and second from one snapshot of the time.
+ *
+ * Use this instead of the single getters when more than one field is
+ * needed, so a rollover between the calls cannot tear the time.
+ *
+ * @param h Receives the hour (023)
+ * @param m Receives the minute (059)
+ * @param s Receives the second (059)
+ */
+void Clock_Get_Time(int* h, int* m, int* s);
+
 // Alarm setters---------------------------------------
+/**
+ * @brief Sets the alarm hour and minute.
+ *
+ * @param h Hour value (023)
+ * @param m Minute value (059)
+ */
+void Clock_Set_Alarm(int h, int m);
+
 /**
  * @brief Adds 1 hour to the alarm time (wraps at 24).
  */
@@ -78,6 +172,15 @@ void Alarm_Add_Hour(void);
  */
 void Alarm_Add_Minute(void);
 
+/**
+ * @brief Moves the alarm minute up to the next multiple of step (wraps at 60).
+ *
+ * With step 5, 17 becomes 20 and 55 becomes 0. Used by the auto-repeat of a held button.
+ *
+ * @param step Minutes per step (1 to 59).
+ */
+void Alarm_Add_Minutes(int step);
+
 /**
  * @brief Adds 1 second to the alarm time (wraps at 60).
  */
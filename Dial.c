@@ -0,0 +1,171 @@
+/**
+ * @file Dial.c
+ * @brief Potentiometer setting dial with quantization, hysteresis and rate limiting.
+ */
+
+#include "Dial.h"
+#include "ADC.h"
+#include "SysTick_Delay.h"
+
+typedef enum {
+    DIAL_OFF,
+    DIAL_WATCHING,
+    DIAL_DIALING
+} Dial_Mode;
+
+static Dial_Mode mode = DIAL_OFF;
+
+// Smoothed position, scaled by 2^DIAL_FILTER_SHIFT to keep the fraction
+static uint32_t position_scaled = 0;
+static bool primed = false;
+
+// Position the knob must leave before the dial follows it
+static uint16_t pickup_reference = 0;
+static bool picked_up = false;
+
+static uint8_t range = 1;
+static uint8_t value = 0;           // Value last reported
+static uint8_t target = 0;          // Zone of the knob, after hysteresis
+static uint64_t last_change_us = 0;
+
+// ==============================
+// Control
+// ==============================
+static void Dial_Arm_Pickup(void)
+{
+    picked_up = false;
+    pickup_reference = (uint16_t)(position_scaled >> DIAL_FILTER_SHIFT);
+}
+
+void Dial_Start(uint8_t dial_range, uint8_t dial_value)
+{
+    range = (dial_range < 2) ? 2 : dial_range;
+    value = (dial_value < range) ? dial_value : (uint8_t)(range - 1);
+    target = value;
+    Dial_Arm_Pickup();
+
+    mode = DIAL_DIALING;
+    ADC_Set_Rate(ADC_USER_DIAL, DIAL_RATE_HZ);
+}
+
+void Dial_Watch(void)
+{
+    Dial_Arm_Pickup();
+
+    mode = DIAL_WATCHING;
+    ADC_Set_Rate(ADC_USER_DIAL, 0);
+}
+
+void Dial_Stop(void)
+{
+    mode = DIAL_OFF;
+    ADC_Set_Rate(ADC_USER_DIAL, 0);
+}
+
+bool Dial_Has_Work(void)
+{
+    return (mode != DIAL_OFF) && ADC_Potentiometer_Has_New();
+}
+
+// ==============================
+// Position
+// ==============================
+static uint8_t Dial_Zone(uint16_t position)
+{
+    return (uint8_t)(((uint32_t)position * range) / (ADC_FULL_SCALE + 1));
+}
+
+// First position of a zone
+static uint16_t Dial_Zone_Start(uint8_t zone)
+{
+    return (uint16_t)(((uint32_t)zone * (ADC_FULL_SCALE + 1)) / range);
+}
+
+// Takes the newest result, returns true while the knob is picked up
+static bool Dial_Update(void)
+{
+    uint16_t counts;
+
+    if (!ADC_Take_Potentiometer(&counts))
+    {
+        return picked_up;
+    }
+
+    // The first result ever primes the filter and the pickup
+    if (!primed)
+    {
+        position_scaled = (uint32_t)counts << DIAL_FILTER_SHIFT;
+        pickup_reference = counts;
+        primed = true;
+        return false;
+    }
+
+    position_scaled = position_scaled - (position_scaled >> DIAL_FILTER_SHIFT) + counts;
+    uint16_t position = (uint16_t)(position_scaled >> DIAL_FILTER_SHIFT);
+
+    if (!picked_up)
+    {
+        uint16_t moved = (position > pickup_reference) ?
+            (uint16_t)(position - pickup_reference) : (uint16_t)(pickup_reference - position);
+
+        if (moved < DIAL_PICKUP_COUNTS)
+        {
+            return false;
+        }
+
+        // Jump straight to the knob's zone
+        picked_up = true;
+        target = Dial_Zone(position);
+        return true;
+    }
+
+    // Leave the target zone only DIAL_HYSTERESIS_COUNTS past its edges
+    uint8_t zone = Dial_Zone(position);
+    if (zone != target)
+    {
+        uint16_t lower = Dial_Zone_Start(target);
+        uint16_t upper = Dial_Zone_Start((uint8_t)(target + 1));
+
+        if (((uint32_t)position + DIAL_HYSTERESIS_COUNTS < lower) ||
+            ((uint32_t)position >= (uint32_t)upper + DIAL_HYSTERESIS_COUNTS))
+        {
+            target = zone;
+        }
+    }
+    return true;
+}
+
+// ==============================
+// Reading
+// ==============================
+bool Dial_Read(uint8_t* dial_value)
+{
+    if ((mode != DIAL_DIALING) || !Dial_Update() || (target == value))
+    {
+        return false;
+    }
+
+    // Rate limit; the change is picked up again with the next result
+    uint64_t now_us = SysTick_Now_us();
+    if ((now_us - last_change_us) < ((uint64_t)DIAL_MIN_UPDATE_MS * 1000))
+    {
+        return false;
+    }
+
+    last_change_us = now_us;
+    value = target;
+    *dial_value = value;
+    return true;
+}
+
+bool Dial_Take_Turned(void)
+{
+    if ((mode != DIAL_WATCHING) || !Dial_Update())
+    {
+        return false;
+    }
+
+    // Report the turn once, then wait for the next one
+    Dial_Arm_Pickup();
+    return true;
+}
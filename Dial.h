@@ -0,0 +1,78 @@
+/**
+ * @file Dial.h
+ *
+ * @brief Interface for using the EduBase potentiometer as a setting dial.
+ *
+ * The potentiometer travel is split into as many equal zones as the value
+ * has steps (24 for hours, 60 for minutes), and the value is the zone the
+ * knob is in. The potentiometer results are smoothed by an exponential
+ * moving average, and the value only moves to a neighbouring zone once the
+ * knob is DIAL_HYSTERESIS_COUNTS past the zone edge, so a knob resting on
+ * an edge does not flicker. The value changes at most once every
+ * DIAL_MIN_UPDATE_MS, which limits the redraws of a fast turn.
+ *
+ * A dial that is started keeps its value until the knob is turned by
+ * DIAL_PICKUP_COUNTS, then follows the knob. A value set with the buttons
+ * is therefore not lost by starting the dial.
+ *
+ * While a dial is watched (Dial_Watch) the potentiometer is only converted
+ * along with the light sensor, at its rate, and a turn is reported once.
+ */
+#ifndef DIAL_H
+#define DIAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Conversion rate while a value is being dialed
+#define DIAL_RATE_HZ 50
+
+// Weight of a new result in the smoothed position: 1 / 2^DIAL_FILTER_SHIFT
+#define DIAL_FILTER_SHIFT 2
+
+// Distance past a zone edge before the value moves
+#define DIAL_HYSTERESIS_COUNTS 16
+
+// Turn needed before a started dial follows the knob
+#define DIAL_PICKUP_COUNTS 64
+
+// Shortest time between two value changes
+#define DIAL_MIN_UPDATE_MS 50
+
+/**
+ * @brief Starts dialing a value at DIAL_RATE_HZ.
+ *
+ * @param range Number of values (2 to 255); the value runs from 0 to range - 1.
+ * @param value Value kept until the knob is turned.
+ */
+void Dial_Start(uint8_t range, uint8_t value);
+
+/**
+ * @brief Watches for the knob being turned, at the rate of the light sensor.
+ */
+void Dial_Watch(void);
+
+/**
+ * @brief Stops dialing or watching and releases the conversion rate.
+ */
+void Dial_Stop(void);
+
+/**
+ * @brief Returns true if a new potentiometer result is waiting for a started or watched dial.
+ */
+bool Dial_Has_Work(void);
+
+/**
+ * @brief Reads the dialed value. Called from the main loop.
+ *
+ * @param value Receives the value when it changed.
+ * @return true if the value changed since the last call.
+ */
+bool Dial_Read(uint8_t* value);
+
+/**
+ * @brief Returns true once after the knob of a watched dial was turned.
+ */
+bool Dial_Take_Turned(void);
+
+#endif
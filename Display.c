@@ -1,33 +1,486 @@
 /**
  * @file Display.c
  * @brief Displays time in HH:MM:SS on EduBase LCD
+ *
+ * All writes go through the LCD driver's RAM shadow. Display_Refresh
+ * sends only the cells that changed since the last refresh.
+ *
+ * The clock page lives in DDRAM columns 0-15 and the message page in
+ * columns 16-31, so switching screens is a display shift, not a redraw.
+ *
+ * The screen is composed from regions. Each region owns a rectangle of
+ * cells, has a priority, and can be shown for a limited number of seconds.
+ * A cell shows the highest-priority visible region covering it, or a
+ * blank. Only the rectangles of regions that changed are recomposed.
+ *
+ * Two clock faces are available: a one-row HH:MM:SS text face and a
+ * two-row "big digits" face built from eight segment glyphs that are
+ * loaded into CGRAM through the driver's glyph cache.
  */
 
 #include "Display.h"
 #include "EduBase_LCD.h"
-#include <stdio.h>
+#include "Format.h"
+#include "Soft_Timer.h"
+#include "Profile.h"
 
+// ==============================
+// Big Digit Segment Glyphs (5x8)
+// ==============================
+static const uint8_t glyph_left_top[8]      = { 0x07, 0x0F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+static const uint8_t glyph_upper_bar[8]     = { 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t glyph_right_top[8]     = { 0x1C, 0x1E, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+static const uint8_t glyph_left_bottom[8]   = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x0F, 0x07 };
+static const uint8_t glyph_lower_bar[8]     = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F };
+static const uint8_t glyph_right_bottom[8]  = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1E, 0x1C };
+static const uint8_t glyph_upper_middle[8]  = { 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x1F };
+static const uint8_t glyph_lower_middle[8]  = { 0x1F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F };
+
+// Segment shapes used by the digit table. Values below SEG_COUNT are glyphs,
+// SEG_BLOCK and SEG_SPACE use characters from the LCD's character ROM
+enum Big_Digit_Segments
+{
+    SEG_LT, SEG_UB, SEG_RT, SEG_LL, SEG_LB, SEG_LR, SEG_UMB, SEG_LMB,
+    SEG_COUNT,
+    SEG_BLOCK = SEG_COUNT,
+    SEG_SPACE
+};
+
+static const uint8_t* const segment_glyphs[SEG_COUNT] =
+{
+    glyph_left_top, glyph_upper_bar, glyph_right_top, glyph_left_bottom,
+    glyph_lower_bar, glyph_right_bottom, glyph_upper_middle, glyph_lower_middle
+};
+
+// Each digit is 3 columns wide: top row then bottom row
+static const uint8_t big_digit_segments[10][2][3] =
+{
+    { { SEG_LT,    SEG_UB,    SEG_RT    }, { SEG_LL,    SEG_LB,    SEG_LR    } }, // 0
+    { { SEG_UB,    SEG_RT,    SEG_SPACE }, { SEG_LB,    SEG_BLOCK, SEG_LB    } }, // 1
+    { { SEG_UMB,   SEG_UMB,   SEG_RT    }, { SEG_LL,    SEG_LB,    SEG_LB    } }, // 2
+    { { SEG_UMB,   SEG_UMB,   SEG_RT    }, { SEG_LB,    SEG_LB,    SEG_LR    } }, // 3
+    { { SEG_LL,    SEG_LB,    SEG_BLOCK }, { SEG_SPACE, SEG_SPACE, SEG_BLOCK } }, // 4
+    { { SEG_LL,    SEG_UMB,   SEG_UMB   }, { SEG_LB,    SEG_LB,    SEG_LR    } }, // 5
+    { { SEG_LT,    SEG_UMB,   SEG_UMB   }, { SEG_LL,    SEG_LB,    SEG_LR    } }, // 6
+    { { SEG_UB,    SEG_UB,    SEG_RT    }, { SEG_SPACE, SEG_SPACE, SEG_BLOCK } }, // 7
+    { { SEG_LT,    SEG_UMB,   SEG_RT    }, { SEG_LL,    SEG_LMB,   SEG_LR    } }, // 8
+    { { SEG_LT,    SEG_UMB,   SEG_RT    }, { SEG_SPACE, SEG_SPACE, SEG_BLOCK } }  // 9
+};
+
+// Full block and middle dot in the HD44780 A00 character ROM
+#define LCD_CHAR_BLOCK      ((char)0xFF)
+#define LCD_CHAR_MIDDLE_DOT ((char)0xA5)
+
+// Columns of the big-digit face: HH:MM with small seconds in the corner
+#define BIG_HOUR_COL     0
+#define BIG_COLON_COL    6
+#define BIG_MINUTE_COL   7
+#define BIG_SECOND_COL   14
+
+static Display_Face current_face = DISPLAY_DEFAULT_FACE;
+
+// Last time drawn by Display_UpdateTime, redrawn when the face changes
+static uint8_t time_shown = 0;
+static int shown_hour = 0;
+static int shown_minute = 0;
+static int shown_second = 0;
+
+// ==============================
+// Regions
+// ==============================
+typedef struct
+{
+    uint8_t row;                            // First row of the rectangle
+    uint8_t col;                            // First DDRAM column of the rectangle
+    uint8_t rows;                           // Height in rows
+    uint8_t width;                          // Width in columns (up to one page)
+    uint8_t priority;                       // Higher priorities cover lower ones
+    uint8_t visible;
+    uint8_t dirty;                          // Content or visibility changed since the last compose
+    Soft_Timer expiry_timer;                // Hides the region when it expires
+    char cells[LCD_ROWS][LCD_COLUMNS];      // Content, relative to the rectangle
+} Display_Region_State;
+
+// First DDRAM column of each page
+#define CLOCK_PAGE_COL      (DISPLAY_PAGE_CLOCK * LCD_COLUMNS)
+#define MESSAGE_PAGE_COL    (DISPLAY_PAGE_MESSAGE * LCD_COLUMNS)
+
+// Clock region rectangle of the text face (the big-digit face covers the whole page)
+#define CLOCK_TEXT_ROW      1
+#define CLOCK_TEXT_WIDTH    8
+
+static Display_Region_State regions[DISPLAY_REGION_COUNT] =
+{
+    //                            row             col                  rows  width             priority
+    [DISPLAY_REGION_TITLE]     = { 0,              CLOCK_PAGE_COL,      1,    LCD_COLUMNS,      0 },
+    [DISPLAY_REGION_CLOCK]     = { CLOCK_TEXT_ROW, CLOCK_PAGE_COL,      1,    CLOCK_TEXT_WIDTH, 1 },
+    [DISPLAY_REGION_COUNTDOWN] = { 1,              CLOCK_PAGE_COL + 11, 1,    5,                2 },
+    [DISPLAY_REGION_STATUS]    = { 0,              MESSAGE_PAGE_COL,    2,    LCD_COLUMNS,      3 }
+};
+
+// Set when every cell of both pages must be recomposed (region geometry changed)
+static uint8_t compose_all = 0;
+
+static void Display_Region_Put(Display_Region region, uint8_t row, uint8_t col, const char* text, uint8_t length)
+{
+    Display_Region_State* r = &regions[region];
+
+    if ((row >= r->rows) || (col >= r->width))
+    {
+        return;
+    }
+
+    if (length > (r->width - col))
+    {
+        length = r->width - col;
+    }
+
+    for (uint8_t i = 0; i < length; i++, col++)
+    {
+        if (r->cells[row][col] != text[i])
+        {
+            r->cells[row][col] = text[i];
+            r->dirty = 1;
+        }
+    }
+}
+
+void Display_Region_Set(Display_Region region, uint8_t row, const char* text)
+{
+    char padded[LCD_COLUMNS];
+    uint8_t width = regions[region].width;
+    uint8_t i = 0;
+
+    for (; (i < width) && (text[i] != '\0'); i++)
+    {
+        padded[i] = text[i];
+    }
+    for (; i < width; i++)
+    {
+        padded[i] = ' ';
+    }
+
+    Display_Region_Put(region, row, 0, padded, width);
+
+    if (!regions[region].visible)
+    {
+        regions[region].visible = 1;
+        regions[region].dirty = 1;
+    }
+}
+
+void Display_Region_Show(Display_Region region, uint16_t seconds)
+{
+    Display_Region_State* r = &regions[region];
+
+    if (!r->visible)
+    {
+        r->visible = 1;
+        r->dirty = 1;
+    }
+
+    if (seconds > 0)
+    {
+        Soft_Timer_Start(&r->expiry_timer, seconds, 0);
+    }
+    else
+    {
+        Soft_Timer_Cancel(&r->expiry_timer);
+    }
+}
+
+void Display_Region_Hide(Display_Region region)
+{
+    Display_Region_State* r = &regions[region];
+
+    if (r->visible)
+    {
+        r->visible = 0;
+        r->dirty = 1;
+    }
+    Soft_Timer_Cancel(&r->expiry_timer);
+}
+
+uint8_t Display_Region_Is_Visible(Display_Region region)
+{
+    return regions[region].visible;
+}
+
+// Expiry timer callback, runs from Soft_Timer_Service
+static void Display_Region_Expired(void* context)
+{
+    Display_Region_Hide((Display_Region)((Display_Region_State*)context - regions));
+}
+
+// ==============================
+// Compositor
+// ==============================
+static char Display_Compose_Cell(uint8_t row, uint8_t col)
+{
+    const Display_Region_State* top = 0;
+
+    for (uint8_t i = 0; i < DISPLAY_REGION_COUNT; i++)
+    {
+        const Display_Region_State* r = &regions[i];
+
+        if (!r->visible ||
+            (row < r->row) || (row >= r->row + r->rows) ||
+            (col < r->col) || (col >= r->col + r->width))
+        {
+            continue;
+        }
+        if ((top == 0) || (r->priority > top->priority))
+        {
+            top = r;
+        }
+    }
+
+    if (top == 0)
+    {
+        return ' ';
+    }
+
+    // Cells a region has never written read as blanks
+    char cell = top->cells[row - top->row][col - top->col];
+    return (cell == '\0') ? ' ' : cell;
+}
+
+static void Display_Compose_Rect(uint8_t row, uint8_t col, uint8_t rows, uint8_t width)
+{
+    char line[LCD_COLUMNS + 1];
+
+    for (uint8_t y = row; y < row + rows; y++)
+    {
+        for (uint8_t x = 0; x < width; x++)
+        {
+            line[x] = Display_Compose_Cell(y, col + x);
+        }
+        line[width] = '\0';
+
+        // Cells are never '\0': CGRAM glyphs use the 0x08-0x0F aliases
+        EduBase_LCD_Shadow_Write(col, y, line);
+    }
+}
+
+static void Display_Compose(void)
+{
+    if (compose_all)
+    {
+        compose_all = 0;
+        for (uint8_t page = 0; page < DISPLAY_PAGE_COUNT; page++)
+        {
+            Display_Compose_Rect(0, page * LCD_COLUMNS, LCD_ROWS, LCD_COLUMNS);
+        }
+        for (uint8_t i = 0; i < DISPLAY_REGION_COUNT; i++)
+        {
+            regions[i].dirty = 0;
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < DISPLAY_REGION_COUNT; i++)
+    {
+        Display_Region_State* r = &regions[i];
+
+        if (r->dirty)
+        {
+            r->dirty = 0;
+            Display_Compose_Rect(r->row, r->col, r->rows, r->width);
+        }
+    }
+}
+
+static Display_Page Display_Select_Page(void)
+{
+    // Any visible region on the message page takes over the screen
+    for (uint8_t i = 0; i < DISPLAY_REGION_COUNT; i++)
+    {
+        if (regions[i].visible && (regions[i].col >= MESSAGE_PAGE_COL))
+        {
+            return DISPLAY_PAGE_MESSAGE;
+        }
+    }
+    return DISPLAY_PAGE_CLOCK;
+}
+
+// Sizes the clock region for the current face
+static void Display_Apply_Face(void)
+{
+    Display_Region_State* clock = &regions[DISPLAY_REGION_CLOCK];
+
+    // The big digits cover the title; the countdown still overlays the corner
+    if (current_face == DISPLAY_FACE_BIG_DIGITS)
+    {
+        clock->row = 0;
+        clock->rows = LCD_ROWS;
+        clock->width = LCD_COLUMNS;
+    }
+    else
+    {
+        clock->row = CLOCK_TEXT_ROW;
+        clock->rows = 1;
+        clock->width = CLOCK_TEXT_WIDTH;
+    }
+}
+
+// ==============================
+// Initialization
+// ==============================
 void Display_Init(void)
 {
     EduBase_LCD_Init();
     EduBase_LCD_Clear_Display();
-    
-    // Set cursor to first row, first column
-    EduBase_LCD_Set_Cursor(0, 0);
-    EduBase_LCD_Display_String("Digital Clock");
+    Display_Apply_Face();
+
+    for (uint8_t i = 0; i < DISPLAY_REGION_COUNT; i++)
+    {
+        Soft_Timer_Setup(&regions[i].expiry_timer, SOFT_TIMER_DOMAIN_SECONDS,
+                         Display_Region_Expired, &regions[i]);
+    }
+
+    // First row shows the title, second row is left blank for time updates
+    Display_Region_Set(DISPLAY_REGION_TITLE, 0, "Digital Clock");
+    Display_Refresh();
+}
+
+void Display_Set_Face(Display_Face face)
+{
+    if (face == current_face)
+    {
+        return;
+    }
+    current_face = face;
+
+    Display_Apply_Face();
+    compose_all = 1;
+
+    // The clock region still holds the old face's cells: draw the time in the new one
+    if (time_shown)
+    {
+        Display_UpdateTime(shown_hour, shown_minute, shown_second);
+    }
+}
+
+Display_Face Display_Get_Face(void)
+{
+    return current_face;
+}
+
+// ==============================
+// Big Digit Rendering
+// ==============================
+static char Display_Segment_Char(uint8_t segment)
+{
+    if (segment == SEG_BLOCK)
+    {
+        return LCD_CHAR_BLOCK;
+    }
+    if (segment == SEG_SPACE)
+    {
+        return ' ';
+    }
+
+    // Uploads the segment to CGRAM only if it is not loaded yet
+    return (char)EduBase_LCD_Glyph_Acquire(segment_glyphs[segment]);
+}
 
-    // Set cursor to second row, first column
-    EduBase_LCD_Set_Cursor(0, 1);
-    EduBase_LCD_Display_String("                "); // Clear second line
+static void Display_Big_Digit(uint8_t col, uint8_t digit)
+{
+    char cells[3];
+
+    for (uint8_t row = 0; row < 2; row++)
+    {
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            cells[i] = Display_Segment_Char(big_digit_segments[digit][row][i]);
+        }
+        Display_Region_Put(DISPLAY_REGION_CLOCK, row, col, cells, 3);
+    }
+}
+
+static void Display_UpdateTime_Big(int hour, int minute, int second)
+{
+    const char colon = LCD_CHAR_MIDDLE_DOT;
+    char seconds[2];
+
+    // Every digit is staged; only the cells that changed mark the region dirty
+    Display_Big_Digit(BIG_HOUR_COL,       hour / 10);
+    Display_Big_Digit(BIG_HOUR_COL + 3,   hour % 10);
+    Display_Big_Digit(BIG_MINUTE_COL,     minute / 10);
+    Display_Big_Digit(BIG_MINUTE_COL + 3, minute % 10);
+
+    Display_Region_Put(DISPLAY_REGION_CLOCK, 0, BIG_COLON_COL, &colon, 1);
+    Display_Region_Put(DISPLAY_REGION_CLOCK, 1, BIG_COLON_COL, &colon, 1);
+    Display_Region_Put(DISPLAY_REGION_CLOCK, 0, BIG_MINUTE_COL + 6, "   ", 3);
+    Display_Region_Put(DISPLAY_REGION_CLOCK, 1, BIG_MINUTE_COL + 6, " ", 1);
+
+    Format_Two_Digits(seconds, (uint8_t)second);
+    Display_Region_Put(DISPLAY_REGION_CLOCK, 1, BIG_SECOND_COL, seconds, 2);
 }
 
+// ==============================
+// Time Display
+// ==============================
 void Display_UpdateTime(int hour, int minute, int second)
 {
-    char str[17];
-    sprintf(str, "%02d:%02d:%02d", hour, minute, second);
+    PROFILE_BEGIN(PROFILE_DISPLAY_UPDATE_TIME);
+
+    time_shown = 1;
+    shown_hour = hour;
+    shown_minute = minute;
+    shown_second = second;
+
+    Display_Region_Show(DISPLAY_REGION_CLOCK, 0);
+
+    if (current_face == DISPLAY_FACE_BIG_DIGITS)
+    {
+        Display_UpdateTime_Big(hour, minute, second);
+    }
+    else
+    {
+        char str[17];
+        Format_Time_HHMMSS(str, hour, minute, second);
+
+        Display_Region_Put(DISPLAY_REGION_CLOCK, 0, 0, str, CLOCK_TEXT_WIDTH);
+    }
+
+    PROFILE_END(PROFILE_DISPLAY_UPDATE_TIME);
+}
+
+// ==============================
+// Pages
+// ==============================
+Display_Page Display_Get_Page(void)
+{
+    return (Display_Page)EduBase_LCD_Get_Visible_Page();
+}
+
+void Display_Show_Message(const char* title, const char* text, uint16_t seconds)
+{
+    Display_Region_Set(DISPLAY_REGION_STATUS, 0, title);
+    Display_Region_Set(DISPLAY_REGION_STATUS, 1, text);
+    Display_Region_Show(DISPLAY_REGION_STATUS, seconds);
+}
+
+void Display_Hide_Message(void)
+{
+    Display_Region_Hide(DISPLAY_REGION_STATUS);
+}
+
+void Display_Refresh(void)
+{
+    PROFILE_BEGIN(PROFILE_DISPLAY_REFRESH);
+
+    Display_Page page = Display_Select_Page();
+
+    Display_Compose();
+
+    // Finish the hidden page before it is shifted into view
+    EduBase_LCD_Shadow_Commit();
+    if (Display_Get_Page() != page)
+    {
+        EduBase_LCD_Show_Page((uint8_t)page);
+    }
 
-    EduBase_LCD_Set_Cursor(0, 1);
-    EduBase_LCD_Display_String("                ");  // Full row clear
-    EduBase_LCD_Set_Cursor(0, 1);
-    EduBase_LCD_Display_String(str);
+    PROFILE_END(PROFILE_DISPLAY_REFRESH);
 }
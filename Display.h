@@ -5,24 +5,160 @@
  *
  * This module handles initializing the LCD and updating the time display
  * in HH:MM:SS format on the second row of the screen.
+ *
+ * Updates are staged in the LCD's RAM shadow and only reach the screen
+ * when Display_Refresh is called.
+ *
+ * The clock can also be drawn as a two-row "big digits" face (HH:MM with
+ * small seconds) built from custom CGRAM glyphs.
+ *
+ * The screen has two pages held in the LCD's off-screen DDRAM: the clock
+ * page and a message page. A hidden page can be updated in the background
+ * and shown with a few display shift commands.
+ *
+ * Each feature owns a region of the screen. Regions have priorities, so an
+ * overlay hides what is below it only while it is visible, and can expire
+ * after a number of seconds (counted by a software timer).
  */
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+
+// Clock faces
+typedef enum {
+    DISPLAY_FACE_TEXT,          // HH:MM:SS on the second row
+    DISPLAY_FACE_BIG_DIGITS     // Two-row HH:MM with seconds in the corner
+} Display_Face;
+
+// Screen pages held in the LCD's DDRAM
+typedef enum {
+    DISPLAY_PAGE_CLOCK   = 0,   // Title and time, updated every second
+    DISPLAY_PAGE_MESSAGE = 1,   // Set-time screen and status messages
+    DISPLAY_PAGE_COUNT
+} Display_Page;
+
+// Screen regions, listed from the lowest to the highest priority
+typedef enum {
+    DISPLAY_REGION_TITLE,       // Clock page, row 0: "Digital Clock"
+    DISPLAY_REGION_CLOCK,       // Clock page: the time, drawn by the selected face
+    DISPLAY_REGION_COUNTDOWN,   // Clock page, row 1, columns 11-15: snooze countdown
+    DISPLAY_REGION_STATUS,      // Message page, both rows: set-time screen and messages
+    DISPLAY_REGION_COUNT
+} Display_Region;
+
+// Face selected at startup; override in the project's preprocessor symbols.
+// main switches faces at runtime when SW5 is held
+#ifndef DISPLAY_DEFAULT_FACE
+#define DISPLAY_DEFAULT_FACE DISPLAY_FACE_TEXT
+#endif
 
 
 /**
  * @brief Initializes the EduBase LCD display.
  *
+ * Soft_Timer_Init must be called first.
+ *
  * Clears the display, shows "Digital Clock" on the first row,
  * and clears the second row for time updates.
  */
 void Display_Init(void);
 
+/**
+ * @brief Selects the clock face drawn by Display_UpdateTime.
+ *
+ * The last time passed to Display_UpdateTime is redrawn in the new face,
+ * so the next Display_Refresh shows it without waiting for the next update.
+ *
+ * @param face DISPLAY_FACE_TEXT or DISPLAY_FACE_BIG_DIGITS
+ */
+void Display_Set_Face(Display_Face face);
+
+/**
+ * @brief Returns the clock face drawn by Display_UpdateTime.
+ */
+Display_Face Display_Get_Face(void);
+
+/**
+ * @brief Replaces one row of a region's content and makes the region visible.
+ *
+ * A pending expiry of the region is kept.
+ *
+ * The text is padded with blanks to the width of the region. The region is
+ * only recomposed if its content or visibility actually changed.
+ *
+ * @param region The region to write.
+ * @param row    The row within the region (0 for one-row regions).
+ * @param text   The new content.
+ */
+void Display_Region_Set(Display_Region region, uint8_t row, const char* text);
+
+/**
+ * @brief Makes a region visible.
+ *
+ * @param region  The region to show.
+ * @param seconds Seconds before the region is hidden again, or 0 to keep it.
+ */
+void Display_Region_Show(Display_Region region, uint16_t seconds);
+
+/**
+ * @brief Hides a region, uncovering the regions below it.
+ *
+ * @param region The region to hide.
+ */
+void Display_Region_Hide(Display_Region region);
+
+/**
+ * @brief Returns 1 if the region is visible, 0 otherwise.
+ */
+uint8_t Display_Region_Is_Visible(Display_Region region);
+
 /**
  * @brief Updates the time shown on the LCD.
  *
- * Displays the time in HH:MM:SS format at the beginning of the second row.
+ * Text face: stages the time in HH:MM:SS format at the beginning of the
+ * second row.
+ * Big digits face: stages HH:MM across both rows and the seconds in the
+ * bottom-right corner. Missing segment glyphs are uploaded to CGRAM.
+ *
+ * Call Display_Refresh to show it.
  *
  * @param hour   Current hour value (023)
  * @param minute Current minute value (059)
  * @param second Current second value (059)
  */
 void Display_UpdateTime(int hour, int minute, int second);
+
+/**
+ * @brief Returns the page currently shown.
+ */
+Display_Page Display_Get_Page(void);
+
+/**
+ * @brief Shows a two-line message in the status region.
+ *
+ * Both rows are padded with blanks. The message page is shown while the
+ * status region is visible; the clock page keeps being updated in the background.
+ *
+ * @param title   Text of the first row (up to 16 characters)
+ * @param text    Text of the second row (up to 16 characters)
+ * @param seconds Seconds before the message is hidden, or 0 to keep it.
+ */
+void Display_Show_Message(const char* title, const char* text, uint16_t seconds);
+
+/**
+ * @brief Hides the status region and returns to the clock page.
+ */
+void Display_Hide_Message(void);
+
+/**
+ * @brief Composes the changed regions and sends them to the LCD.
+ *
+ * Only the rectangles of regions whose content or visibility changed are
+ * recomposed, and only the cells that differ from what the LCD already
+ * shows are transmitted. The page is then switched if a message was
+ * shown or hidden.
+ */
+void Display_Refresh(void);
+
+#endif
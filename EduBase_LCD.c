@@ -20,145 +20,478 @@
  */
  
 #include "EduBase_LCD.h"
+#include "GPIO_HAL.h"
+#include "Format.h"
+#include "SysClock.h"
+#include "Profile.h"
+
+// Timer 1A runs from the system clock
+#define LCD_TIMER_TICKS_PER_US SYSCLOCK_CYCLES_PER_US
+
+// Bus timing of the selected panel profile, in microseconds:
+//  - ADDRESS_SETUP:        RS and data lines valid before E rises (tAS)
+//  - ENABLE_PULSE:         E high time (PWEH)
+//  - NIBBLE_HOLD:          E low time after every nibble (tH, tcycE)
+//  - DATA_EXECUTION:       Write Data to RAM execution time, including tADD
+//  - COMMAND_EXECUTION:    Execution time of every command except Clear Display and Return Home
+//  - CLEAR_HOME_EXECUTION: Clear Display and Return Home execution time
+#if (EDUBASE_LCD_TIMING_PROFILE == LCD_TIMING_PROFILE_CONSERVATIVE)
+	// Delays of the original driver with a 1 ms wait after every nibble
+	#define LCD_ADDRESS_SETUP_US          1
+	#define LCD_ENABLE_PULSE_US           1
+	#define LCD_NIBBLE_HOLD_US            1000
+	#define LCD_DATA_EXECUTION_US         0
+	#define LCD_COMMAND_EXECUTION_US      37
+	#define LCD_CLEAR_HOME_EXECUTION_US   1520
+#elif (EDUBASE_LCD_TIMING_PROFILE == LCD_TIMING_PROFILE_TUNED)
+	// Execution times from page 24 of the HD44780 datasheet (fosc = 270 kHz)
+	// scaled to the 190 kHz minimum oscillator frequency
+	#define LCD_ADDRESS_SETUP_US          1
+	#define LCD_ENABLE_PULSE_US           1
+	#define LCD_NIBBLE_HOLD_US            1
+	#define LCD_DATA_EXECUTION_US         58
+	#define LCD_COMMAND_EXECUTION_US      53
+	#define LCD_CLEAR_HOME_EXECUTION_US   2160
+#else
+	#error "Unknown EDUBASE_LCD_TIMING_PROFILE"
+#endif
+
+// Reject profiles that violate the HD44780 datasheet (pages 24 and 49).
+// A 1 us setup and pulse width covers tAS (40 ns), PWEH (450 ns) and tcycE (1000 ns)
+#if (LCD_ADDRESS_SETUP_US < 1) || (LCD_ENABLE_PULSE_US < 1)
+	#error "LCD timing profile violates the enable pulse timing"
+#endif
+
+#if (LCD_NIBBLE_HOLD_US + LCD_DATA_EXECUTION_US < 41) || \
+	(LCD_NIBBLE_HOLD_US + LCD_COMMAND_EXECUTION_US < 37) || \
+	(LCD_NIBBLE_HOLD_US + LCD_CLEAR_HOME_EXECUTION_US < 1520)
+	#error "LCD timing profile violates the instruction execution times"
+#endif
+
+// The longest engine step must fit in the 32-bit Timer 1A reload
+_Static_assert(((uint64_t)(LCD_NIBBLE_HOLD_US + LCD_CLEAR_HOME_EXECUTION_US) * LCD_TIMER_TICKS_PER_US) <= 0xFFFFFFFFULL,
+               "LCD engine delay does not fit in the Timer 1A reload");
+
+// Number of entries in the transmit queue (must be a power of two)
+#define LCD_QUEUE_SIZE 64
+
+// LCD pin groups written through the masked DATA addresses
+static const GPIO_Pin_Group lcd_data_pins = GPIO_PIN_GROUP(GPIO_PORTA_BASE, 0x3C);
+static const GPIO_Pin_Group lcd_enable_pin = GPIO_PIN_GROUP(GPIO_PORTC_BASE, 0x40);
+static const GPIO_Pin_Group lcd_register_select_pin = GPIO_PIN_GROUP(GPIO_PORTE_BASE, 0x01);
 
 static uint8_t display_control = 0x00;
 static uint8_t display_mode = 0x00;
 
+// Number of enable pulses generated on the LCD bus
+static uint32_t bus_transactions = 0;
+
+// RAM shadow of the visible DDRAM cells and a copy of what the LCD currently shows.
+// A cell value of 0x00 in panel_buffer marks its content as unknown
+static char shadow_buffer[LCD_ROWS][LCD_DDRAM_COLUMNS];
+static char panel_buffer[LCD_ROWS][LCD_DDRAM_COLUMNS];
+
+// Number of columns the display is shifted to the left (0 - 39)
+static uint8_t display_shift = 0;
+
+// DDRAM address counter of the LCD after every queued byte has executed.
+// Set Cursor commands that would not move it are dropped
+#define LCD_ADDRESS_UNKNOWN 0xFF
+static uint8_t ddram_address = LCD_ADDRESS_UNKNOWN;
+static uint8_t address_increment = 0x01;
+static uint32_t cursor_commands_sent = 0;
+static uint32_t cursor_commands_saved = 0;
+static uint8_t shadow_dirty = 0x00;
+
+// Glyph cache: pattern loaded in each CGRAM slot and when it was last acquired
+static const uint8_t* glyph_slot_pattern[LCD_GLYPH_SLOTS];
+static uint32_t glyph_slot_last_use[LCD_GLYPH_SLOTS];
+static uint32_t glyph_use_counter = 0;
+static uint32_t glyph_uploads = 0;
+static uint32_t glyph_hits = 0;
+
+// Transmit queue drained by the Timer 1A interrupt. Each entry holds
+// one byte and its register select flag
+typedef struct
+{
+	uint8_t value;
+	uint8_t control_flag;
+} LCD_Queue_Entry;
+
+static LCD_Queue_Entry transmit_queue[LCD_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+static uint8_t queue_high_water = 0;
+
+// States of the transmit engine. A byte is sent as two passes through
+// SET_NIBBLE -> RAISE_ENABLE -> DROP_ENABLE
+enum LCD_Engine_States
+{
+	LCD_ENGINE_IDLE,
+	LCD_ENGINE_SET_NIBBLE,
+	LCD_ENGINE_RAISE_ENABLE,
+	LCD_ENGINE_DROP_ENABLE
+};
+
+static volatile uint8_t engine_state = LCD_ENGINE_IDLE;
+static uint8_t engine_byte = 0;
+static uint8_t engine_control_flag = 0;
+static uint8_t engine_lower_nibble = 0;
+
 void EduBase_LCD_Ports_Init(void)
 {
+	// Select the bus aperture (AHB or APB) of the GPIO ports
+	GPIO_Bus_Init();
+	
 	// Enable the clock to Port A by setting the
 	// R0 bit (Bit 0) in the RCGCGPIO register
 	SYSCTL->RCGCGPIO |= 0x01;
 	
 	// Configure the PA5, PA4, PA3, and PA2 pins as output
 	// by setting Bits 5 to 2 in the DIR register
-	GPIOA->DIR |= 0x3C;
+	GPIO_PORTA->DIR |= 0x3C;
 
 	// Configure the PA5, PA4, PA3, and PA2 pins to function as
 	// GPIO pins by clearing Bits 5 to 2 in the AFSEL register
-	GPIOA->AFSEL &= ~0x3C;
+	GPIO_PORTA->AFSEL &= ~0x3C;
 
 	// Enable the digital functionality for the PA5, PA4, PA3, and PA2 pins
 	// by setting Bits 5 to 2 in the DEN register
-	GPIOA->DEN |= 0x3C;
+	GPIO_PORTA->DEN |= 0x3C;
 	
 	// Initialize the output of the PA5, PA4, PA3, and PA2 pins to zero
-	// by clearing Bits 5 to 2 in the DATA register
-	GPIOA->DATA &= ~0x3C;
+	// through the masked DATA address of Bits 5 to 2
+	GPIO_Pin_Group_Clear(&lcd_data_pins);
 	
 	// Enable the clock to Port C by setting the
 	// R2 bit (Bit 2) in the RCGCGPIO register
 	SYSCTL->RCGCGPIO |= 0x04;
 	
 	// Configure the PC6 pin as output by setting Bit 6 in the DIR register
-	GPIOC->DIR |= 0x40;
+	GPIO_PORTC->DIR |= 0x40;
 	
 	// Configure the PC6 pin to function as a GPIO pin
 	// by clearing Bit 6 in the AFSEL register
-	GPIOC->AFSEL &= ~0x40;
+	GPIO_PORTC->AFSEL &= ~0x40;
 	
 	// Enable the digital functionality for the PA6 pin
 	// by setting Bit 6 in the DEN register
-	GPIOC->DEN |= 0x40;
+	GPIO_PORTC->DEN |= 0x40;
 	
 	// Initialize the output of the PC6 pin to zero
-	// by clearing Bit 6 in the DATA register
-	GPIOC->DATA &= ~0x40;
+	// through the masked DATA address of Bit 6
+	GPIO_Pin_Group_Clear(&lcd_enable_pin);
 	
 	// Enable the clock to Port E by setting the
 	// R4 bit (Bit 4) in the RCGCGPIO register
 	SYSCTL->RCGCGPIO |= 0x10;
 	
 	// Configure the PE0 pin as output by setting Bit 0 in the DIR register
-	GPIOE->DIR |= 0x01;
+	GPIO_PORTE->DIR |= 0x01;
 	
 	// Configure the PE0 pin to function as a GPIO pin
 	// by clearing Bit 0 in the AFSEL register
-	GPIOE->AFSEL &= ~0x01;
+	GPIO_PORTE->AFSEL &= ~0x01;
 	
 	// Enable the digital functionality for the PE0 pin
 	// by setting Bit 0 in the DEN register
-	GPIOE->DEN |= 0x01;
+	GPIO_PORTE->DEN |= 0x01;
 	
 	// Initialize the output of the PE0 pin to zero
-	// by clearing Bit 0 in the DATA register
-	GPIOE->DATA &= ~0x01;
+	// through the masked DATA address of Bit 0
+	GPIO_Pin_Group_Clear(&lcd_register_select_pin);
 }
 
 void EduBase_LCD_Pulse_Enable(void)
 {
 	// Ensure that the output of the PC6 pin is zero before sending a short pulse
-	GPIOC->DATA &= ~0x40;
-	SysTick_Delay1us(1);
+	GPIO_Pin_Group_Clear(&lcd_enable_pin);
+	SysTick_Delay1us(LCD_ADDRESS_SETUP_US);
 	
 	// Output a short pulse on the PC6 pin by setting Bit 6
-  // in the DATA register high and clearing it after 1 us. 
+  // in the DATA register high and clearing it after the enable pulse width. 
 	// The minimum time for the enable pulse width must be at least greater than 450 ns
 	// during a read / write operation (page 49 of HD44780 datasheet)
-	GPIOC->DATA |= 0x40;
-	SysTick_Delay1us(1);
-	GPIOC->DATA &= ~0x40;
+	GPIO_Pin_Group_Set(&lcd_enable_pin);
+	SysTick_Delay1us(LCD_ENABLE_PULSE_US);
+	GPIO_Pin_Group_Clear(&lcd_enable_pin);
 }
 
 void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag)
 {
 	// Set the upper nibble of the data on the data pins (PA2 - PA5)
-	GPIOA->DATA |= (data & 0xF0) >> 0x2;
+	GPIO_Pin_Group_Write(&lcd_data_pins, (data & 0xF0) >> 0x2);
 	
 	// Set or clear the register select (RS) pin based on the control flag
 	// 0 for command and 1 for data
-	if (control_flag & 0x01)
+	GPIO_Pin_Group_Write(&lcd_register_select_pin, control_flag & 0x01);
+	
+	// Output a short pulse on the PC6 pin to enable the LCD
+	EduBase_LCD_Pulse_Enable();
+	bus_transactions++;
+	
+	// Clear the LCD data lines (PA2 - PA5) and hold them for the profile's nibble hold time
+	GPIO_Pin_Group_Clear(&lcd_data_pins);
+	SysTick_Delay1us(LCD_NIBBLE_HOLD_US);
+}
+
+void EduBase_LCD_Send_Command(uint8_t command)
+{
+	EduBase_LCD_Queue_Command(command);
+	EduBase_LCD_Wait_Idle();
+}
+
+void EduBase_LCD_Send_Data(uint8_t data)
+{
+	EduBase_LCD_Queue_Data(data);
+	EduBase_LCD_Wait_Idle();
+}
+
+void EduBase_LCD_Engine_Init(void)
+{
+	// Enable the clock to Timer 1
+	SYSCTL->RCGCTIMER |= 0x02;
+	
+	// Disable Timer 1A before configuration
+	TIMER1->CTL = 0x00;
+	
+	// Configure for 32-bit timer mode
+	TIMER1->CFG = 0x00;
+	
+	// Configure Timer 1A for one-shot mode. Each timeout
+	// advances the transmit engine by one step
+	TIMER1->TAMR = 0x01;
+	
+	// Clear the timeout flag and enable the timeout interrupt
+	TIMER1->ICR = 0x01;
+	TIMER1->IMR = 0x01;
+	
+	engine_state = LCD_ENGINE_IDLE;
+	queue_head = 0;
+	queue_tail = 0;
+	
+	NVIC_EnableIRQ(TIMER1A_IRQn);
+}
+
+static void EduBase_LCD_Enqueue(uint8_t value, uint8_t control_flag)
+{
+	uint8_t next_head = (queue_head + 1) & (LCD_QUEUE_SIZE - 1);
+	
+	// Wait for the engine to free a slot if the queue is full
+	while (next_head == queue_tail);
+	
+	transmit_queue[queue_head].value = value;
+	transmit_queue[queue_head].control_flag = control_flag;
+	
+	// The entry must be complete before the engine can see it
+	__DMB();
+	queue_head = next_head;
+	
+	uint8_t queue_depth = (queue_head - queue_tail) & (LCD_QUEUE_SIZE - 1);
+	if (queue_depth > queue_high_water)
 	{
-		GPIOE->DATA |= 0x01;
+		queue_high_water = queue_depth;
 	}
 	
-	else
+	// Start the engine if it has gone idle. Interrupts are masked so that
+	// the engine cannot go idle between the check and the restart
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	if (engine_state == LCD_ENGINE_IDLE)
 	{
-		GPIOE->DATA &= ~0x01;
+		engine_state = LCD_ENGINE_SET_NIBBLE;
+		engine_lower_nibble = 0;
+		NVIC_SetPendingIRQ(TIMER1A_IRQn);
 	}
 	
-	// Output a short pulse on the PC6 pin to enable the LCD
-	EduBase_LCD_Pulse_Enable();
-	
-	// Clear the LCD data lines (PA2 - PA5) and provide a 1 ms delay
-	GPIOA->DATA &= ~0x3C;
-	SysTick_Delay1us(1000);
+	__set_PRIMASK(primask);
 }
 
-void EduBase_LCD_Send_Command(uint8_t command)
+// Returns the DDRAM address after a data write at address. In two-line mode
+// address 0x27 is followed by 0x40 and address 0x67 by 0x00
+static uint8_t EduBase_LCD_Next_Address(uint8_t address)
+{
+	if (address_increment)
+	{
+		return (address == 0x27) ? 0x40 : (address == 0x67) ? 0x00 : (address + 1);
+	}
+	return (address == 0x40) ? 0x27 : (address == 0x00) ? 0x67 : (address - 1);
+}
+
+void EduBase_LCD_Queue_Command(uint8_t command)
 {
-	// Transmit the upper nibble of the command byte
-	EduBase_LCD_Write_4_Bits(command & 0xF0, SEND_COMMAND_FLAG);
+	EduBase_LCD_Enqueue(command, SEND_COMMAND_FLAG);
 	
-	// Transmit the lower nibble of the command byte
-	EduBase_LCD_Write_4_Bits(command << 0x4, SEND_COMMAND_FLAG);
+	// Follow the effect of the command on the address counter. The
+	// instruction is identified by its highest set bit
+	if (command & SET_DDRAM_ADDR)
+	{
+		ddram_address = command & 0x7F;
+	}
+	else if (command & SET_CGRAM_ADDR)
+	{
+		ddram_address = LCD_ADDRESS_UNKNOWN;
+	}
+	else if (command & FUNCTION_SET)
+	{
+		// No effect on the address counter
+	}
+	else if (command & CURSOR_OR_DISPLAY_SHIFT)
+	{
+		if ((command & DISPLAY_MOVE) == 0)
+		{
+			ddram_address = LCD_ADDRESS_UNKNOWN;
+		}
+	}
+	else if (command & DISPLAY_CONTROL)
+	{
+		// No effect on the address counter
+	}
+	else if (command & ENTRY_MODE_SET)
+	{
+		address_increment = ((command & ENTRY_SHIFT_INCREMENT) != 0);
+	}
+	else if (command != 0x00)
+	{
+		// Clear Display and Return Home
+		ddram_address = 0x00;
+	}
+}
+
+void EduBase_LCD_Queue_Data(uint8_t data)
+{
+	EduBase_LCD_Enqueue(data, SEND_DATA_FLAG);
 	
-	// Provide a delay based on the transmitted command
-	// The first two commands require 1.52 ms execution time
-	// while the rest of the commands need 37 us
-	if (command < 3)
+	if (ddram_address != LCD_ADDRESS_UNKNOWN)
 	{
-		SysTick_Delay1us(1520);
+		ddram_address = EduBase_LCD_Next_Address(ddram_address);
 	}
-	else
+}
+
+void EduBase_LCD_Wait_Idle(void)
+{
+	while (engine_state != LCD_ENGINE_IDLE);
+}
+
+uint8_t EduBase_LCD_Is_Idle(void)
+{
+	return (engine_state == LCD_ENGINE_IDLE);
+}
+
+uint8_t EduBase_LCD_Get_Queue_High_Water(void)
+{
+	return queue_high_water;
+}
+
+// Runs one step of the transmit engine
+static void EduBase_LCD_Engine_Step(void)
+{
+	uint32_t delay_in_us = 0;
+	
+	switch (engine_state)
 	{
-		SysTick_Delay1us(37);
+		case LCD_ENGINE_SET_NIBBLE:
+		{
+			// Fetch the next byte before sending its upper nibble
+			if (engine_lower_nibble == 0)
+			{
+				if (queue_tail == queue_head)
+				{
+					engine_state = LCD_ENGINE_IDLE;
+					return;
+				}
+				
+				engine_byte = transmit_queue[queue_tail].value;
+				engine_control_flag = transmit_queue[queue_tail].control_flag;
+				queue_tail = (queue_tail + 1) & (LCD_QUEUE_SIZE - 1);
+			}
+			
+			uint8_t nibble = engine_lower_nibble ? (engine_byte << 0x4) : (engine_byte & 0xF0);
+			
+			// Set the nibble on the data pins (PA2 - PA5) and the register select (RS) pin
+			GPIO_Pin_Group_Write(&lcd_data_pins, (nibble & 0xF0) >> 0x2);
+			GPIO_Pin_Group_Write(&lcd_register_select_pin, engine_control_flag & 0x01);
+			
+			engine_state = LCD_ENGINE_RAISE_ENABLE;
+			delay_in_us = LCD_ADDRESS_SETUP_US;
+			break;
+		}
+		
+		case LCD_ENGINE_RAISE_ENABLE:
+		{
+			// Hold the enable pin high for longer than 450 ns (page 49 of HD44780 datasheet)
+			GPIO_Pin_Group_Set(&lcd_enable_pin);
+			engine_state = LCD_ENGINE_DROP_ENABLE;
+			delay_in_us = LCD_ENABLE_PULSE_US;
+			break;
+		}
+		
+		case LCD_ENGINE_DROP_ENABLE:
+		{
+			// Latch the nibble and clear the data lines (PA2 - PA5)
+			GPIO_Pin_Group_Clear(&lcd_enable_pin);
+			GPIO_Pin_Group_Clear(&lcd_data_pins);
+			bus_transactions++;
+			
+			delay_in_us = LCD_NIBBLE_HOLD_US;
+			
+			if (engine_lower_nibble == 0)
+			{
+				engine_lower_nibble = 1;
+			}
+			else
+			{
+				engine_lower_nibble = 0;
+				
+				// Wait for the byte to execute. Clear Display and Return Home
+				// take much longer than the rest of the commands
+				if ((engine_control_flag & 0x01) == SEND_DATA_FLAG)
+				{
+					delay_in_us += LCD_DATA_EXECUTION_US;
+				}
+				else if (engine_byte < 3)
+				{
+					delay_in_us += LCD_CLEAR_HOME_EXECUTION_US;
+				}
+				else
+				{
+					delay_in_us += LCD_COMMAND_EXECUTION_US;
+				}
+			}
+			
+			engine_state = LCD_ENGINE_SET_NIBBLE;
+			break;
+		}
+		
+		default:
+		{
+			return;
+		}
 	}
+	
+	// Schedule the next step of the engine
+	TIMER1->TAILR = (delay_in_us * LCD_TIMER_TICKS_PER_US) - 1;
+	TIMER1->CTL |= 0x01;
 }
 
-void EduBase_LCD_Send_Data(uint8_t data)
+void TIMER1A_Handler(void)
 {
-	// Transmit the upper nibble of the data byte
-	EduBase_LCD_Write_4_Bits(data & 0xF0, SEND_DATA_FLAG);
+	PROFILE_BEGIN(PROFILE_TIMER1A_ISR);
 	
-	// Transmit the lower nibble of the data byte
-	EduBase_LCD_Write_4_Bits(data << 0x4, SEND_DATA_FLAG);
+	// Clear the timeout flag
+	TIMER1->ICR = 0x01;
+	
+	EduBase_LCD_Engine_Step();
+	
+	PROFILE_END(PROFILE_TIMER1A_ISR);
 }
 
 void EduBase_LCD_Init(void)
 {
-	// Initialize the GPIO pins used by the LCD
+	// Initialize the GPIO pins used by the LCD and the transmit engine
 	EduBase_LCD_Ports_Init();
+	EduBase_LCD_Engine_Init();
 	
 	// Provide a delay of 50 ms after the LCD is powered on
 	SysTick_Delay1us(50000);
@@ -175,6 +508,7 @@ void EduBase_LCD_Init(void)
 	
 	// Transmit a Function Set command to the LCD to configure it to use 4-bit mode
 	EduBase_LCD_Write_4_Bits(FUNCTION_SET | CONFIG_FOUR_BIT_MODE, SEND_COMMAND_FLAG);
+	SysTick_Delay1us(LCD_COMMAND_EXECUTION_US);
 	
 	// Configure the LCD to use 5x8 dots and two rows
 	EduBase_LCD_Send_Command(FUNCTION_SET | CONFIG_5x8_DOTS | CONFIG_TWO_LINES);
@@ -192,120 +526,385 @@ void EduBase_LCD_Init(void)
 	// Turn off the cursor and the blinking of cursor position character
 	EduBase_LCD_Disable_Cursor_Blink();
 	EduBase_LCD_Disable_Cursor();
+	
+	// Set the address counter to increment after every write. The driver
+	// relies on it to skip Set Cursor commands between consecutive writes
+	EduBase_LCD_Left_to_Right();
 }
 
 void EduBase_LCD_Clear_Display(void)
 {
-	EduBase_LCD_Send_Command(CLEAR_DISPLAY);
+	EduBase_LCD_Queue_Command(CLEAR_DISPLAY);
+	
+	// The Clear Display command fills the DDRAM with spaces and
+	// returns the display from being shifted
+	display_shift = 0;
+	memset(shadow_buffer, ' ', sizeof(shadow_buffer));
+	memset(panel_buffer, ' ', sizeof(panel_buffer));
+	shadow_dirty = 0x00;
 }
 
 void EduBase_LCD_Return_Home(void)
 {
-	EduBase_LCD_Send_Command(RETURN_HOME);
+	EduBase_LCD_Queue_Command(RETURN_HOME);
+	display_shift = 0;
+}
+
+// Moves the address counter to a DDRAM address. Returns 1 if the
+// Set Cursor command was dropped because the counter is already there
+static uint8_t EduBase_LCD_Move_Cursor(uint8_t address)
+{
+	if (address == ddram_address)
+	{
+		cursor_commands_saved++;
+		return 1;
+	}
+	
+	EduBase_LCD_Queue_Command(SET_DDRAM_ADDR | address);
+	cursor_commands_sent++;
+	return 0;
 }
 
 void EduBase_LCD_Set_Cursor(uint8_t col, uint8_t row)
 {
-	if (col < 16)
+	if (col < LCD_DDRAM_COLUMNS)
 	{
 		if (row == 0)
 		{
-			EduBase_LCD_Send_Command(SET_DDRAM_ADDR | col);
+			EduBase_LCD_Move_Cursor(col);
 		}
 		
 		else if (row == 1)
 		{
-			EduBase_LCD_Send_Command(SET_DDRAM_ADDR | (col + 0x40));
+			EduBase_LCD_Move_Cursor(col + 0x40);
 		}
 	}
 }
 
+uint8_t EduBase_LCD_Write_Span(uint8_t col, uint8_t row, const char* buffer, uint8_t length)
+{
+	if ((row >= LCD_ROWS) || (col >= LCD_DDRAM_COLUMNS))
+	{
+		return 0;
+	}
+	
+	uint8_t commands_saved = EduBase_LCD_Move_Cursor((row == 0) ? col : (col + 0x40));
+	
+	// Stream the bytes and let the address counter advance on its own
+	for (uint8_t i = 0; i < length; i++)
+	{
+		EduBase_LCD_Queue_Data(buffer[i]);
+	}
+	
+	return commands_saved;
+}
+
+void EduBase_LCD_Get_Cursor_Stats(uint32_t* sent, uint32_t* saved)
+{
+	*sent = cursor_commands_sent;
+	*saved = cursor_commands_saved;
+}
+
 void EduBase_LCD_Disable_Display(void)
 {
 	display_control = display_control & ~(DISPLAY_ON);
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Enable_Display(void)
 {
 	display_control = display_control | DISPLAY_ON;
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Disable_Cursor(void)
 {
 	display_control = display_control & ~CURSOR_ON;
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Enable_Cursor(void)
 {
 	display_control = display_control | CURSOR_ON;
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Disable_Cursor_Blink(void)
 {
 	display_control = display_control & ~CURSOR_BLINK_ON;
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Enable_Cursor_Blink(void)
 {
 	display_control = display_control | CURSOR_BLINK_ON;
-	EduBase_LCD_Send_Command(DISPLAY_CONTROL | display_control);
+	EduBase_LCD_Queue_Command(DISPLAY_CONTROL | display_control);
 }
 
 void EduBase_LCD_Scroll_Display_Left(void)
 {
-	EduBase_LCD_Send_Command(CURSOR_OR_DISPLAY_SHIFT | DISPLAY_MOVE | MOVE_LEFT);
+	EduBase_LCD_Queue_Command(CURSOR_OR_DISPLAY_SHIFT | DISPLAY_MOVE | MOVE_LEFT);
+	display_shift = (display_shift + 1) % LCD_DDRAM_COLUMNS;
 }
 
 void EduBase_LCD_Scroll_Display_Right(void)
 {
-	EduBase_LCD_Send_Command(CURSOR_OR_DISPLAY_SHIFT | DISPLAY_MOVE | MOVE_RIGHT);
+	EduBase_LCD_Queue_Command(CURSOR_OR_DISPLAY_SHIFT | DISPLAY_MOVE | MOVE_RIGHT);
+	display_shift = (display_shift + LCD_DDRAM_COLUMNS - 1) % LCD_DDRAM_COLUMNS;
 }
 
 void EduBase_LCD_Left_to_Right(void)
 {
 	display_mode = display_mode | ENTRY_SHIFT_INCREMENT;
-	EduBase_LCD_Send_Command(ENTRY_MODE_SET | display_mode);
+	EduBase_LCD_Queue_Command(ENTRY_MODE_SET | display_mode);
 }
 
 void EduBase_LCD_Right_to_Left(void)
 {
 	display_mode = display_mode & ~ENTRY_SHIFT_INCREMENT;
-	EduBase_LCD_Send_Command(ENTRY_MODE_SET | display_mode);
+	EduBase_LCD_Queue_Command(ENTRY_MODE_SET | display_mode);
 }
 
-void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buffer[])
+void EduBase_LCD_Create_Custom_Character(uint8_t location, const uint8_t character_buffer[])
 {
 	location = location & 0x7;
-	EduBase_LCD_Send_Command(SET_CGRAM_ADDR | (location << 3));
+	
+	// The glyph cache no longer knows what this slot holds
+	glyph_slot_pattern[location] = NULL;
+	
+	EduBase_LCD_Queue_Command(SET_CGRAM_ADDR | (location << 3));
 	for (int i = 0; i < 8; i++)
 	{
-		EduBase_LCD_Send_Data(character_buffer[i]);
+		EduBase_LCD_Queue_Data(character_buffer[i]);
 	}
 }
 
 void EduBase_LCD_Display_String(char* string)
 {
-	for (unsigned int i = 0; i < strlen(string); i++)
+	for (; *string != '\0'; string++)
 	{
-		EduBase_LCD_Send_Data(string[i]);
+		EduBase_LCD_Queue_Data(*string);
 	}
 }
 
 void EduBase_LCD_Display_Integer(int value)
 {
 	char integer_buffer[32];
-	sprintf(integer_buffer, "%d", value);
+	Format_Integer(integer_buffer, value);
 	EduBase_LCD_Display_String(integer_buffer);
 }
 
+void EduBase_LCD_Display_Fixed(int32_t value, uint8_t decimals)
+{
+	char fixed_buffer[32];
+	Format_Fixed(fixed_buffer, value, decimals);
+	EduBase_LCD_Display_String(fixed_buffer);
+}
+
 void EduBase_LCD_Display_Double(double value)
 {
 	char double_buffer[32];
-	sprintf(double_buffer, "%.6f", value);
+	uint8_t length = 0;
+	
+	if (value < 0.0)
+	{
+		double_buffer[length++] = '-';
+		value = -value;
+	}
+	
+	// Split the value into its integer part and six fraction digits,
+	// rounded to the nearest millionth
+	uint32_t integer_part = (uint32_t)value;
+	uint32_t fraction_part = (uint32_t)((value - integer_part) * 1000000.0 + 0.5);
+	
+	if (fraction_part >= 1000000)
+	{
+		integer_part = integer_part + 1;
+		fraction_part = fraction_part - 1000000;
+	}
+	
+	length += Format_Unsigned(&double_buffer[length], integer_part);
+	double_buffer[length++] = '.';
+	Format_Unsigned_Padded(&double_buffer[length], fraction_part, 6);
+	
 	EduBase_LCD_Display_String(double_buffer);
 }
+
+// Returns the column after the last column of the 16-column page that contains col
+static uint8_t EduBase_LCD_Page_End(uint8_t col)
+{
+	uint8_t page_end = ((col / LCD_COLUMNS) + 1) * LCD_COLUMNS;
+	return (page_end > LCD_DDRAM_COLUMNS) ? LCD_DDRAM_COLUMNS : page_end;
+}
+
+void EduBase_LCD_Shadow_Write(uint8_t col, uint8_t row, const char* string)
+{
+	if ((row >= LCD_ROWS) || (col >= LCD_DDRAM_COLUMNS))
+	{
+		return;
+	}
+	
+	uint8_t page_end = EduBase_LCD_Page_End(col);
+	
+	for (; (*string != '\0') && (col < page_end); string++, col++)
+	{
+		shadow_buffer[row][col] = *string;
+	}
+	
+	shadow_dirty = 0x01;
+}
+
+void EduBase_LCD_Shadow_Fill(uint8_t col, uint8_t row, char character, uint8_t length)
+{
+	if ((row >= LCD_ROWS) || (col >= LCD_DDRAM_COLUMNS))
+	{
+		return;
+	}
+	
+	uint8_t page_end = EduBase_LCD_Page_End(col);
+	
+	for (; (length > 0) && (col < page_end); length--, col++)
+	{
+		shadow_buffer[row][col] = character;
+	}
+	
+	shadow_dirty = 0x01;
+}
+
+void EduBase_LCD_Shadow_Commit(void)
+{
+	if (shadow_dirty == 0x00)
+	{
+		return;
+	}
+	
+	PROFILE_BEGIN(PROFILE_LCD_SHADOW_COMMIT);
+	
+	shadow_dirty = 0x00;
+	
+	for (uint8_t row = 0; row < LCD_ROWS; row++)
+	{
+		uint8_t col = 0;
+		
+		while (col < LCD_DDRAM_COLUMNS)
+		{
+			// Skip the cells that already match what the LCD shows
+			if (shadow_buffer[row][col] == panel_buffer[row][col])
+			{
+				col++;
+				continue;
+			}
+			
+			// Extend the run while the cells differ. A single unchanged cell between two
+			// changes is rewritten since it costs the same as another Set Cursor command
+			uint8_t run_end = col + 1;
+			
+			while (run_end < LCD_DDRAM_COLUMNS)
+			{
+				if (shadow_buffer[row][run_end] != panel_buffer[row][run_end])
+				{
+					run_end = run_end + 1;
+				}
+				else if ((run_end + 1 < LCD_DDRAM_COLUMNS) &&
+					(shadow_buffer[row][run_end + 1] != panel_buffer[row][run_end + 1]))
+				{
+					run_end = run_end + 2;
+				}
+				else
+				{
+					break;
+				}
+			}
+			
+			// Send the run with a single Set Cursor command, which is dropped
+			// if the previous run left the address counter on its first cell
+			EduBase_LCD_Write_Span(col, row, &shadow_buffer[row][col], run_end - col);
+			memcpy(&panel_buffer[row][col], &shadow_buffer[row][col], run_end - col);
+			col = run_end;
+		}
+	}
+	
+	PROFILE_END(PROFILE_LCD_SHADOW_COMMIT);
+}
+
+void EduBase_LCD_Shadow_Invalidate(void)
+{
+	memset(panel_buffer, 0x00, sizeof(panel_buffer));
+	shadow_dirty = 0x01;
+}
+
+uint32_t EduBase_LCD_Get_Bus_Transactions(void)
+{
+	return bus_transactions;
+}
+
+uint8_t EduBase_LCD_Glyph_Acquire(const uint8_t pattern[])
+{
+	uint8_t victim_slot = 0;
+	
+	glyph_use_counter++;
+	
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++)
+	{
+		if (glyph_slot_pattern[slot] == pattern)
+		{
+			glyph_slot_last_use[slot] = glyph_use_counter;
+			glyph_hits++;
+			return LCD_GLYPH_CHAR_BASE + slot;
+		}
+		
+		// Prefer an empty slot, otherwise the least recently acquired one
+		if ((glyph_slot_pattern[victim_slot] != NULL) &&
+			((glyph_slot_pattern[slot] == NULL) ||
+			(glyph_slot_last_use[slot] < glyph_slot_last_use[victim_slot])))
+		{
+			victim_slot = slot;
+		}
+	}
+	
+	EduBase_LCD_Create_Custom_Character(victim_slot, pattern);
+	glyph_slot_pattern[victim_slot] = pattern;
+	glyph_slot_last_use[victim_slot] = glyph_use_counter;
+	glyph_uploads++;
+	
+	return LCD_GLYPH_CHAR_BASE + victim_slot;
+}
+
+void EduBase_LCD_Get_Glyph_Stats(uint32_t* uploads, uint32_t* hits)
+{
+	*uploads = glyph_uploads;
+	*hits = glyph_hits;
+}
+
+void EduBase_LCD_Show_Page(uint8_t page)
+{
+	if (page >= LCD_PAGES)
+	{
+		return;
+	}
+	
+	// Number of left shifts needed to bring the page's first column to the left edge
+	uint8_t target_shift = page * LCD_COLUMNS;
+	uint8_t left_shifts = (target_shift + LCD_DDRAM_COLUMNS - display_shift) % LCD_DDRAM_COLUMNS;
+	
+	// Shift in the shorter direction
+	if (left_shifts <= (LCD_DDRAM_COLUMNS / 2))
+	{
+		for (uint8_t i = 0; i < left_shifts; i++)
+		{
+			EduBase_LCD_Scroll_Display_Left();
+		}
+	}
+	else
+	{
+		for (uint8_t i = 0; i < (LCD_DDRAM_COLUMNS - left_shifts); i++)
+		{
+			EduBase_LCD_Scroll_Display_Right();
+		}
+	}
+}
+
+uint8_t EduBase_LCD_Get_Visible_Page(void)
+{
+	return display_shift / LCD_COLUMNS;
+}
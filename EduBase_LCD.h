@@ -13,6 +13,10 @@
  *	- LCD Enable      [E]   (PC6)
  *  - Register Select [RS]  (PE0)
  *
+ * Commands and data are queued and sent by an interrupt-driven transmit engine
+ * that uses Timer 1A. Every function below EduBase_LCD_Init returns as soon as
+ * its transfers are queued; call EduBase_LCD_Wait_Idle to wait for them.
+ *
  * @note For more information regarding the LCD, refer to the HD44780 LCD Controller Datasheet.
  * Link: https://www.sparkfun.com/datasheets/LCD/HD44780.pdf
  *
@@ -22,7 +26,17 @@
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
 #include <string.h>
-#include <stdio.h>
+
+// HD44780 bus timing profiles. The profile is chosen at compile time by defining
+// EDUBASE_LCD_TIMING_PROFILE (e.g. in the project's preprocessor symbols)
+//  - CONSERVATIVE: the original 1 ms wait after every nibble
+//  - TUNED:        datasheet execution times with margin for a slow controller oscillator
+#define LCD_TIMING_PROFILE_CONSERVATIVE   0
+#define LCD_TIMING_PROFILE_TUNED          1
+
+#ifndef EDUBASE_LCD_TIMING_PROFILE
+#define EDUBASE_LCD_TIMING_PROFILE LCD_TIMING_PROFILE_TUNED
+#endif
 
 static uint8_t up_arrow[8] =
 {
@@ -138,6 +152,20 @@ enum LCD_Register_Select_Flags
 	SEND_DATA_FLAG          = 0x01
 };
 
+enum LCD_Geometry
+{
+	LCD_ROWS                = 2,
+	LCD_COLUMNS             = 16,
+	LCD_DDRAM_COLUMNS       = 40,
+	LCD_PAGES               = 2
+};
+
+enum LCD_Glyph_Cache
+{
+	LCD_GLYPH_SLOTS         = 8,
+	LCD_GLYPH_CHAR_BASE     = 0x08
+};
+
 enum Custom_Character_CGRAM_Locations
 {
 	UP_ARROW_LOCATION       = 0x00,
@@ -171,6 +199,7 @@ void EduBase_LCD_Ports_Init(void);
  * This function generates a short pulse on the LCD enable pin (PC6) to initiate
  * data transmission to the 16x2 Liquid Crystal Display (LCD) on the EduBase board.
  * A minimum pulse width greater than 450 nanoseconds is provided as specified in the datasheet.
+ * The setup and pulse widths are taken from the selected timing profile.
  *
  * @param None
  *
@@ -198,13 +227,13 @@ void EduBase_LCD_Pulse_Enable(void);
 void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag);
 
 /**
- * @brief Sends a command to the LCD.
+ * @brief Sends a command to the LCD and waits until it has been executed.
  *
- * This function sends an 8-bit command to the LCD using the EduBase_LCD_Write_4_Bits function.
- * It transmits the upper nibble of the command first, and then it transmits the lower nibble. The timing 
- * of the delays after sending the command depends on the specific command being executed.
- * For the first two commands (i.e. Clear Display and Return Home), a delay of 1.52 ms is required.
- * The rest of the commands require a delay of 37 us.
+ * This function is a blocking wrapper around EduBase_LCD_Queue_Command. It queues the 8-bit
+ * command and then waits in EduBase_LCD_Wait_Idle until the queue has drained. The Timer1A
+ * engine times each command's execution from the selected timing profile (LCD_*_EXECUTION_US
+ * in EduBase_LCD.c), so the wait also covers every command queued before this one. Use
+ * EduBase_LCD_Queue_Command where waiting is not needed.
  *
  * @param command The 8-bit command to be sent to the LCD.
  *
@@ -215,10 +244,9 @@ void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag);
 void EduBase_LCD_Send_Command(uint8_t command);
 
 /**
- * @brief Sends an 8-bit data byte to the LCD.
+ * @brief Sends an 8-bit data byte to the LCD and waits until it has been written.
  *
- * This function sends an 8-bit data byte to the LCD using the EduBase_LCD_Write_4_Bits function.
- * It transmits the upper nibble of the command first, and then it transmits the lower nibble.
+ * This function is a blocking wrapper around EduBase_LCD_Queue_Data.
  *
  * @param data The 8-bit data byte to be sent to the LCD.
  *
@@ -226,6 +254,77 @@ void EduBase_LCD_Send_Command(uint8_t command);
  */
 void EduBase_LCD_Send_Data(uint8_t data);
 
+/**
+ * @brief Initializes the interrupt-driven transmit engine of the LCD driver.
+ *
+ * This function configures Timer 1A in one-shot mode. Every timeout of Timer 1A advances
+ * the transmit engine by one step (set nibble, raise E, drop E, wait for execution time),
+ * so the CPU is free between the edges on the LCD bus.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void EduBase_LCD_Engine_Init(void);
+
+/**
+ * @brief Queues a command for the transmit engine and returns without waiting.
+ *
+ * The function only blocks if the transmit queue is full.
+ *
+ * @param command The 8-bit command to be sent to the LCD.
+ *
+ * @return None
+ */
+void EduBase_LCD_Queue_Command(uint8_t command);
+
+/**
+ * @brief Queues a data byte for the transmit engine and returns without waiting.
+ *
+ * The function only blocks if the transmit queue is full.
+ *
+ * @param data The 8-bit data byte to be sent to the LCD.
+ *
+ * @return None
+ */
+void EduBase_LCD_Queue_Data(uint8_t data);
+
+/**
+ * @brief Waits until every queued command and data byte has reached the LCD.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void EduBase_LCD_Wait_Idle(void);
+
+/**
+ * @brief Indicates whether the transmit engine has finished all queued transfers.
+ *
+ * @param None
+ *
+ * @return 1 if the transmit queue is empty and the engine is idle, 0 otherwise.
+ */
+uint8_t EduBase_LCD_Is_Idle(void);
+
+/**
+ * @brief Returns the largest number of entries that have been waiting in the transmit queue.
+ *
+ * @param None
+ *
+ * @return The transmit queue depth high-water mark.
+ */
+uint8_t EduBase_LCD_Get_Queue_High_Water(void);
+
+/**
+ * @brief Timer 1A interrupt handler. Advances the transmit engine by one step.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void TIMER1A_Handler(void);
+
 /**
  * @brief Initializes the LCD module connected to the EduBase board.
  *
@@ -268,9 +367,11 @@ void EduBase_LCD_Return_Home(void);
  * @brief Sets the cursor position on the LCD.
  *
  * This function sets the cursor position on the LCD based on the specified column and row.
- * It assumes that a 16x2 LCD is used.
+ * It assumes that a 16x2 LCD is used. The HD44780 holds 40 columns per row, so columns
+ * 16 - 39 address DDRAM that is off-screen unless the display is shifted.
+ * The command is not sent if the cursor is already at that position.
  *
- * @param col The column index (0-15) where the cursor should be positioned.
+ * @param col The DDRAM column index (0-39) where the cursor should be positioned.
  *
  * @param row The row index (0 or 1) where the cursor should be positioned.
  *
@@ -278,6 +379,41 @@ void EduBase_LCD_Return_Home(void);
  */
 void EduBase_LCD_Set_Cursor(uint8_t col, uint8_t row);
 
+/**
+ * @brief Writes a run of characters to consecutive DDRAM cells.
+ *
+ * The driver tracks the LCD's DDRAM address counter, so the Set Cursor command is
+ * dropped when the counter already points at (col, row), e.g. right after a write
+ * that ended on the previous cell. The bytes are then streamed and the counter's
+ * auto-increment moves the cursor. Unlike EduBase_LCD_Display_String, the length
+ * is given, so the buffer does not need to be null-terminated.
+ *
+ * @param col The DDRAM column index (0-39) of the first cell.
+ *
+ * @param row The row index (0 or 1) of the cells.
+ *
+ * @param buffer The characters to write.
+ *
+ * @param length The number of characters to write.
+ *
+ * @return The number of commands saved by this call (1 if the Set Cursor command was dropped, 0 otherwise).
+ */
+uint8_t EduBase_LCD_Write_Span(uint8_t col, uint8_t row, const char* buffer, uint8_t length);
+
+/**
+ * @brief Returns how many Set Cursor commands were sent and how many were dropped.
+ *
+ * A Set Cursor command is dropped when the tracked DDRAM address counter
+ * already points at the requested cell.
+ *
+ * @param sent Number of Set Cursor commands queued since initialization.
+ *
+ * @param saved Number of Set Cursor commands dropped since initialization.
+ *
+ * @return None
+ */
+void EduBase_LCD_Get_Cursor_Stats(uint32_t* sent, uint32_t* saved);
+
 /**
  * @brief Disables the display on the LCD.
  *
@@ -392,7 +528,36 @@ void EduBase_LCD_Right_to_Left(void);
  *
  * @return None
  */
-void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buffer[]);
+void EduBase_LCD_Create_Custom_Character(uint8_t location, const uint8_t character_buffer[]);
+
+/**
+ * @brief Returns the character code of a custom glyph, uploading it to CGRAM only if it is missing.
+ *
+ * The glyph cache remembers which pattern is loaded in each of the eight CGRAM slots.
+ * Patterns are identified by their address, so they must be stored in constant arrays.
+ * If the pattern is not loaded, it is uploaded to an empty slot or, if all slots are
+ * in use, to the least recently acquired slot. Evicting a slot changes every cell that
+ * still shows the old glyph, so a screen should not use more than eight glyphs at once.
+ *
+ * The returned code is in the range 0x08 - 0x0F, which maps to the same CGRAM slots
+ * as 0x00 - 0x07, so it can be stored in null-terminated strings.
+ *
+ * @param pattern An array of eight rows containing the pixel pattern of the glyph.
+ *
+ * @return The DDRAM character code that displays the glyph.
+ */
+uint8_t EduBase_LCD_Glyph_Acquire(const uint8_t pattern[]);
+
+/**
+ * @brief Returns the glyph cache statistics.
+ *
+ * @param uploads Receives the number of glyphs uploaded to CGRAM.
+ *
+ * @param hits Receives the number of acquisitions served by an already loaded glyph.
+ *
+ * @return None
+ */
+void EduBase_LCD_Get_Glyph_Stats(uint32_t* uploads, uint32_t* hits);
 
 /**
  * @brief Displays a string on the LCD.
@@ -407,7 +572,7 @@ void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buf
 void EduBase_LCD_Display_String(char* string);
 
 /**
- * @brief Converts the integer value to string to display it on the LCD using sprintf.
+ * @brief Converts the integer value to string to display it on the LCD.
  *
  * @param value An integer that will be converted to string.
  *
@@ -416,10 +581,130 @@ void EduBase_LCD_Display_String(char* string);
 void EduBase_LCD_Display_Integer(int value);
 
 /**
- * @brief Converts the double value to string to display it on the LCD using sprintf.
+ * @brief Converts a fixed-point value to string to display it on the LCD.
+ *
+ * For example, value = 1650 and decimals = 3 displays "1.650".
+ *
+ * @param value The value scaled by 10^decimals.
+ *
+ * @param decimals The number of digits after the decimal point (0-9).
+ *
+ * @return None
+ */
+void EduBase_LCD_Display_Fixed(int32_t value, uint8_t decimals);
+
+/**
+ * @brief Converts the double value to string with six decimal places to display it on the LCD.
+ *
+ * The value is split into its integer and fraction parts without sprintf.
+ * Prefer EduBase_LCD_Display_Fixed, which needs no floating-point math.
  *
  * @param value A double that will be converted to string.
  *
  * @return None
  */
 void EduBase_LCD_Display_Double(double value);
+
+/**
+ * @brief Writes a string into the RAM shadow of the LCD's DDRAM.
+ *
+ * This function copies a null-terminated string into the shadow framebuffer starting at
+ * the specified column and row. Nothing is sent to the LCD until EduBase_LCD_Shadow_Commit
+ * is called. Characters that fall past the last column of the 16-column page that contains
+ * col are discarded.
+ *
+ * @param col The DDRAM column index (0-39) of the first character. Page p starts at column 16 * p.
+ *
+ * @param row The row index (0 or 1) of the first character.
+ *
+ * @param string A char pointer that holds the address of a sequence of char values (i.e. string).
+ *
+ * @return None
+ */
+void EduBase_LCD_Shadow_Write(uint8_t col, uint8_t row, const char* string);
+
+/**
+ * @brief Fills a range of cells in the RAM shadow with a single character.
+ *
+ * @param col The DDRAM column index (0-39) of the first cell.
+ *
+ * @param row The row index (0 or 1) of the cells.
+ *
+ * @param character The character written to every cell in the range.
+ *
+ * @param length The number of cells to fill. The range is clipped to the last column of the page.
+ *
+ * @return None
+ */
+void EduBase_LCD_Shadow_Fill(uint8_t col, uint8_t row, char character, uint8_t length);
+
+/**
+ * @brief Sends the cells of the RAM shadow that differ from what the LCD currently shows.
+ *
+ * This function compares the shadow framebuffer against a copy of the LCD's DDRAM contents
+ * and only transmits the changed cells. Adjacent changes (including runs separated by a single
+ * unchanged cell) are grouped into one Set Cursor command followed by a run of data writes
+ * that rely on the DDRAM address auto-increment. It returns immediately if nothing has been
+ * written to the shadow since the last commit.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void EduBase_LCD_Shadow_Commit(void);
+
+/**
+ * @brief Forces the next commit to retransmit every cell of the RAM shadow.
+ *
+ * This function must be called after the LCD has been written directly (e.g. with
+ * EduBase_LCD_Display_String) since the driver can no longer tell what the LCD shows.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void EduBase_LCD_Shadow_Invalidate(void);
+
+/**
+ * @brief Returns the number of 4-bit bus transactions sent to the LCD since initialization.
+ *
+ * Each command or data byte costs two transactions (upper and lower nibble).
+ *
+ * @param None
+ *
+ * @return The number of enable pulses generated on the LCD bus.
+ */
+uint32_t EduBase_LCD_Get_Bus_Transactions(void);
+
+/**
+ * @brief Shows a page of the off-screen DDRAM by shifting the display.
+ *
+ * The HD44780 holds 40 columns per row but shows only 16 of them. Page 0 covers
+ * DDRAM columns 0 - 15 and page 1 covers columns 16 - 31, so a page can be written
+ * while it is hidden and then shown with a burst of Display Shift commands
+ * instead of rewriting 32 characters.
+ * The remaining 8 columns cannot hold a full page without overlapping page 0.
+ *
+ * @note A flip between pages 0 and 1 costs 16 Display Shift commands, queued in one
+ *       call. With the tuned timing profile each takes about 59 us on the bus, so
+ *       the flip takes about 0.95 ms (about 33 ms with the conservative profile).
+ *       Rewriting both rows of a page into the visible columns instead would take
+ *       32 data writes and 2 Set DDRAM Address commands, about 2 ms. The flip uses
+ *       16 of the 64 transmit queue entries, so a refresh that queues a full page
+ *       of changes before it can wait for the queue to drain. It returns without
+ *       sending anything when the page is already shown.
+ *
+ * @param page The page to show (0 or 1).
+ *
+ * @return None
+ */
+void EduBase_LCD_Show_Page(uint8_t page);
+
+/**
+ * @brief Returns the page currently shown on the LCD.
+ *
+ * @param None
+ *
+ * @return The visible page (0 or 1).
+ */
+uint8_t EduBase_LCD_Get_Visible_Page(void);
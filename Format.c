@@ -0,0 +1,149 @@
+/**
+ * @file Format.c
+ * @brief printf-free number formatting for the LCD display paths.
+ *
+ * Replaces sprintf on the paths that run every second. Two-digit fields
+ * come from a lookup table and fixed layouts are copied from constant
+ * templates, so no format string is parsed at run time.
+ */
+
+#include "Format.h"
+#include <string.h>
+
+// ==============================
+// Two-Digit Lookup Table
+// ==============================
+static const char two_digit_table[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// ==============================
+// Fixed Layout Templates
+// ==============================
+const Format_Template FORMAT_TIME_HHMMSS = { "00:00:00",    8,  3, { 0, 3, 6 } };
+const Format_Template FORMAT_SET_HHMM    = { "SET 00:00",   9,  2, { 4, 7 } };
+const Format_Template FORMAT_ALARM_HHMM  = { "ALARM 00:00", 11, 2, { 6, 9 } };
+const Format_Template FORMAT_COUNTDOWN   = { "CD:00",       5,  1, { 3 } };
+
+// ==============================
+// Two-Digit Conversion
+// ==============================
+char* Format_Two_Digits(char* buffer, uint8_t value)
+{
+    const char* digits = &two_digit_table[(value % 100) * 2];
+    buffer[0] = digits[0];
+    buffer[1] = digits[1];
+    return buffer + 2;
+}
+
+// ==============================
+// Template Formatting
+// ==============================
+void Format_Template_Apply(char* buffer, const Format_Template* layout, const uint8_t values[])
+{
+    memcpy(buffer, layout->text, layout->length + 1);
+
+    for (uint8_t i = 0; i < layout->field_count; i++)
+    {
+        Format_Two_Digits(&buffer[layout->field_offsets[i]], values[i]);
+    }
+}
+
+void Format_Time_HHMMSS(char* buffer, int hour, int minute, int second)
+{
+    const uint8_t values[3] = { (uint8_t)hour, (uint8_t)minute, (uint8_t)second };
+    Format_Template_Apply(buffer, &FORMAT_TIME_HHMMSS, values);
+}
+
+// ==============================
+// Integer Formatting
+// ==============================
+uint8_t Format_Unsigned_Padded(char* buffer, uint32_t value, uint8_t width)
+{
+    // Fill from the last digit, two digits per table lookup
+    uint8_t i = width;
+    while (i >= 2)
+    {
+        i -= 2;
+        Format_Two_Digits(&buffer[i], (uint8_t)(value % 100));
+        value /= 100;
+    }
+    if (i == 1)
+    {
+        buffer[0] = (char)('0' + (value % 10));
+    }
+
+    buffer[width] = '\0';
+    return width;
+}
+
+// Number of decimal digits in value (at least 1)
+static uint8_t Format_Digit_Count(uint32_t value)
+{
+    uint8_t count = 1;
+    while (value >= 10)
+    {
+        value /= 10;
+        count++;
+    }
+    return count;
+}
+
+uint8_t Format_Unsigned(char* buffer, uint32_t value)
+{
+    return Format_Unsigned_Padded(buffer, value, Format_Digit_Count(value));
+}
+
+uint8_t Format_Integer(char* buffer, int32_t value)
+{
+    uint8_t length = 0;
+
+    // Negate in unsigned arithmetic so INT32_MIN is handled
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+        magnitude = 0u - magnitude;
+    }
+
+    length += Format_Unsigned(&buffer[length], magnitude);
+    return length;
+}
+
+uint8_t Format_Fixed(char* buffer, int32_t value, uint8_t decimals)
+{
+    static const uint32_t powers_of_ten[10] =
+    {
+        1u, 10u, 100u, 1000u, 10000u,
+        100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+    };
+
+    if (decimals > 9)
+    {
+        decimals = 9;
+    }
+
+    uint8_t length = 0;
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+        magnitude = 0u - magnitude;
+    }
+
+    uint32_t integer_part = magnitude / powers_of_ten[decimals];
+    uint32_t fraction_part = magnitude % powers_of_ten[decimals];
+
+    length += Format_Unsigned(&buffer[length], integer_part);
+
+    if (decimals > 0)
+    {
+        buffer[length++] = '.';
+        length += Format_Unsigned_Padded(&buffer[length], fraction_part, decimals);
+    }
+
+    return length;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file Format.h
+ *
+ * @brief Interface for printf-free number formatting used by the display paths.
+ *
+ * This module converts integers and fixed-point values to text without
+ * the C library's format parser. Two-digit fields are converted with a
+ * table lookup, and fixed layouts such as HH:MM:SS are described by
+ * constant templates whose digit fields are filled in place.
+ */
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdint.h>
+
+// Maximum number of two-digit fields in a template
+#define FORMAT_MAX_FIELDS 3
+
+/**
+ * @brief Fixed text layout with two-digit fields.
+ *
+ * text holds the fixed characters of the layout. The characters at
+ * each field offset are replaced by a zero-padded two-digit value.
+ */
+typedef struct
+{
+    const char* text;
+    uint8_t length;
+    uint8_t field_count;
+    uint8_t field_offsets[FORMAT_MAX_FIELDS];
+} Format_Template;
+
+// Fixed layouts used by the display paths
+extern const Format_Template FORMAT_TIME_HHMMSS;   // "HH:MM:SS"
+extern const Format_Template FORMAT_SET_HHMM;      // "SET HH:MM"
+extern const Format_Template FORMAT_ALARM_HHMM;    // "ALARM HH:MM"
+extern const Format_Template FORMAT_COUNTDOWN;     // "CD:SS"
+
+/**
+ * @brief Writes a zero-padded two-digit value using a table lookup.
+ *
+ * No terminator is written.
+ *
+ * @param buffer Destination for the two characters.
+ * @param value  Value to convert (099). Larger values keep their last two digits.
+ *
+ * @return Pointer to the character after the two digits.
+ */
+char* Format_Two_Digits(char* buffer, uint8_t value);
+
+/**
+ * @brief Fills a fixed-layout template.
+ *
+ * Copies the template text into buffer (including the terminator)
+ * and writes one two-digit value into each field.
+ *
+ * @param buffer   Destination, at least template->length + 1 characters.
+ * @param layout   The template to fill.
+ * @param values   One value per template field.
+ */
+void Format_Template_Apply(char* buffer, const Format_Template* layout, const uint8_t values[]);
+
+/**
+ * @brief Formats the time as "HH:MM:SS".
+ *
+ * @param buffer Destination, at least 9 characters.
+ * @param hour   Hour value (023)
+ * @param minute Minute value (059)
+ * @param second Second value (059)
+ */
+void Format_Time_HHMMSS(char* buffer, int hour, int minute, int second);
+
+/**
+ * @brief Writes an unsigned value zero-padded to a fixed width.
+ *
+ * @param buffer Destination, at least width + 1 characters.
+ * @param value  Value to convert.
+ * @param width  Number of digits (110). Higher digits that do not fit are dropped.
+ *
+ * @return Number of characters written, excluding the terminator.
+ */
+uint8_t Format_Unsigned_Padded(char* buffer, uint32_t value, uint8_t width);
+
+/**
+ * @brief Converts an unsigned integer to decimal text.
+ *
+ * @param buffer Destination, at least 11 characters.
+ * @param value  Value to convert.
+ *
+ * @return Number of characters written, excluding the terminator.
+ */
+uint8_t Format_Unsigned(char* buffer, uint32_t value);
+
+/**
+ * @brief Converts a signed integer to decimal text.
+ *
+ * @param buffer Destination, at least 12 characters.
+ * @param value  Value to convert.
+ *
+ * @return Number of characters written, excluding the terminator.
+ */
+uint8_t Format_Integer(char* buffer, int32_t value);
+
+/**
+ * @brief Converts a fixed-point value to decimal text.
+ *
+ * For example, value = 1234 and decimals = 3 gives "1.234".
+ *
+ * @param buffer   Destination, at least 13 characters.
+ * @param value    Value scaled by 10^decimals.
+ * @param decimals Number of digits after the decimal point (09).
+ *
+ * @return Number of characters written, excluding the terminator.
+ */
+uint8_t Format_Fixed(char* buffer, int32_t value, uint8_t decimals);
+
+#endif
@@ -16,6 +16,7 @@
  */
 
 #include "GPIO.h"
+#include "GPIO_HAL.h"
 
 // Constant definitions for the user LED (RGB) colors
 const uint8_t RGB_LED_OFF 		= 0x00;
@@ -27,28 +28,36 @@ const uint8_t RGB_LED_GREEN 	= 0x08;
 const uint8_t EDUBASE_LED_ALL_OFF = 0x0;
 const uint8_t EDUBASE_LED_ALL_ON	= 0xF;
 
+// Pin groups written through the masked DATA addresses
+static const GPIO_Pin_Group rgb_led_pins = GPIO_PIN_GROUP(GPIO_PORTF_BASE, 0x0E);
+static const GPIO_Pin_Group edubase_led_pins = GPIO_PIN_GROUP(GPIO_PORTB_BASE, 0x0F);
+static const GPIO_Pin_Group edubase_button_pins = GPIO_PIN_GROUP(GPIO_PORTD_BASE, 0x0F);
+
 void RGB_LED_Init(void)
 {
+	// Select the bus aperture (AHB or APB) of the GPIO ports
+	GPIO_Bus_Init();
+	
 	// Enable the clock to Port F
 	SYSCTL->RCGCGPIO |= 0x20;
 
 	// Set PF1, PF2, and PF3 as output GPIO pins
-	GPIOF->DIR |= 0x0E;
+	GPIO_PORTF->DIR |= 0x0E;
 	
 	// Configure PF1, PF2, and PF3 to function as GPIO pins
-	GPIOF->AFSEL &= ~0x0E;
+	GPIO_PORTF->AFSEL &= ~0x0E;
 	
 	// Enable digital functionality for PF1, PF2, and PF3
-	GPIOF->DEN |= 0x0E;
+	GPIO_PORTF->DEN |= 0x0E;
 	
 	// Initialize the output of the RGB LED to zero
-	GPIOF->DATA &= ~0x0E;
+	GPIO_Pin_Group_Clear(&rgb_led_pins);
 }
 
 void RGB_LED_Output(uint8_t led_value)
 {
-	// Set the output of the RGB LED
-	GPIOF->DATA = (GPIOF->DATA & 0xF1) | led_value;
+	// Set the output of the RGB LED. Only PF1 - PF3 are written
+	GPIO_Pin_Group_Write(&rgb_led_pins, led_value);
 }
 
 uint8_t RGB_LED_Status(void)
@@ -56,47 +65,53 @@ uint8_t RGB_LED_Status(void)
 	// Assign the value of Port F to a local variable
 	// and only read the values of the following bits: 3, 2, and 1
 	// Then, return the local variable's value
-	uint8_t RGB_LED_Status = GPIOF->DATA & 0x0E;
+	uint8_t RGB_LED_Status = GPIO_Pin_Group_Read(&rgb_led_pins);
 	return RGB_LED_Status;
 }
 
 void EduBase_LEDs_Init(void)
 {
+	// Select the bus aperture (AHB or APB) of the GPIO ports
+	GPIO_Bus_Init();
+	
 	// Enable the clock to Port B
 	SYSCTL->RCGCGPIO |= 0x02;
 	
 	// Set PB0, PB1, PB2, and PB3 as output GPIO pins
-	GPIOB->DIR |= 0x0F;
+	GPIO_PORTB->DIR |= 0x0F;
 	
 	// Configure PB0, PB1, PB2, and PB3 to function as GPIO pins
-	GPIOB->AFSEL &= ~0x0F;
+	GPIO_PORTB->AFSEL &= ~0x0F;
 	
 	// Enable digital functionality for PB0, PB1, PB2, and PB3
-	GPIOB->DEN |= 0x0F;
+	GPIO_PORTB->DEN |= 0x0F;
 	
 	// Initialize the output of the EduBase LEDs to zero
-	GPIOB->DATA &= ~0x0F;
+	GPIO_Pin_Group_Clear(&edubase_led_pins);
 }
 
 void EduBase_LEDs_Output(uint8_t led_value)
 {
-	// Set the output of the LEDs
-	GPIOB->DATA = (GPIOB->DATA & 0xF0) | led_value;
+	// Set the output of the LEDs. Only PB0 - PB3 are written
+	GPIO_Pin_Group_Write(&edubase_led_pins, led_value);
 }
 
 void EduBase_Button_Init(void)
 {
+	// Select the bus aperture (AHB or APB) of the GPIO ports
+	GPIO_Bus_Init();
+	
 	// Enable the clock to Port D
 	SYSCTL->RCGCGPIO |= 0x08;
 	
 	// Set PD0, PD1, PD2, and PD3 as input GPIO pins
-	GPIOD->DIR &= ~0x0F;
+	GPIO_PORTD->DIR &= ~0x0F;
 	
 	// Configure PD0, PD1, PD2, and PD3 to function as GPIO pins
-	GPIOD->AFSEL &= ~0x0F;
+	GPIO_PORTD->AFSEL &= ~0x0F;
 	
 	// Enable digital functionality for PD0, PD1, PD2, and PD3
-	GPIOD->DEN |= 0x0F;
+	GPIO_PORTD->DEN |= 0x0F;
 }
 
 uint8_t Get_EduBase_Button_Status(void)
@@ -104,6 +119,6 @@ uint8_t Get_EduBase_Button_Status(void)
 	// Assign the value of Port D to a local variable
 	// and only read the values of the following bits: 3, 2, 1, and 0
 	// Then, return the local variable's value
-	uint8_t button_status = GPIOD->DATA & 0x0F;
+	uint8_t button_status = GPIO_Pin_Group_Read(&edubase_button_pins);
 	return button_status;
 }
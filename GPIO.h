@@ -47,10 +47,8 @@ void RGB_LED_Init(void);
  * @brief The RGB_LED_Output function sets the output of the RGB LED.
  *
  * This function sets the output of the RGB LED based on the value of the input, led_value.
- * A bitwise AND operation (& 0xF1) is performed to mask the Bits 1 to 3 of the GPIOF's DATA register
- * to preserve the state of other pins connected to Port F while keeping the RGB LED pins unaffected.
- * Then, a bitwise OR operation is performed with led_value to set the RGB LED pins to the desired state
- * specified by led_value.
+ * The value is stored to the masked DATA address of Bits 1 to 3 of Port F, so the state
+ * of the other pins connected to Port F is preserved without a read-modify-write.
  *
  * @param led_value An 8-bit unsigned integer that determines the output of the RGB LED. To turn off
  *                  the RGB LED, set led_value to 0. The following values determine the color of the RGB LED:
@@ -102,10 +100,9 @@ void EduBase_LEDs_Init(void);
  * @brief The EduBase_LEDs_Output function sets the output of the EduBase Board LEDs.
  *
  * This function sets the output of the EduBase Board LEDs based on the value of the input, led_value.
- * A bitwise AND operation (& 0xF0) is performed to mask the lower four bits (Bits 0 to 3) of the GPIOF's DATA register
- * to preserve the state of other pins connected to Port B while keeping the LED pins unaffected.
- * Then, a bitwise OR operation is performed with led_value to set the LED pins to the desired state
- * specified by led_value.
+ * The value is stored to the masked DATA address of the lower four bits (Bits 0 to 3) of Port B,
+ * so the state of the other pins connected to Port B (e.g. the buzzer on PB6) is preserved
+ * without a read-modify-write.
  *
  * @param led_value An 8-bit unsigned integer that determines the output of the EduBase Board LEDs.
  *
@@ -130,7 +127,7 @@ void EduBase_Button_Init(void);
  *
  * This function reads the status of the EduBase Board buttons connected to pins PD0, PD1, PD2, and PD3.
  * It indicates whether or not the buttons are pressed and returns the status.
- * A bitwise AND operation (& 0xF) is performed to mask the unused bits in the data register.
+ * The masked DATA address of Bits 0 to 3 is read, so the unused bits read as zero.
  *
  * @param None
  *
@@ -0,0 +1,182 @@
+/**
+ * @file GPIO_HAL.h
+ *
+ * @brief Pin group access layer for the TM4C123 GPIO ports.
+ *
+ * Every GPIO port decodes address bits [9:2] of its DATA register as a
+ * bit mask: a write to (port base + (mask << 2)) only changes the pins
+ * selected by the mask, and a read from it returns zero for every other pin.
+ * A pin group descriptor holds that masked DATA address, so writing a pin
+ * group compiles to a single store with no read-modify-write of the port.
+ * This also makes writes from interrupt handlers safe against writes from
+ * the main loop to other pins of the same port.
+ *
+ * Refer to Section 10.3.1.2 (Data Register Operation) of the TM4C123GH6PM datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mario Hernandez
+ */
+#ifndef GPIO_HAL_H
+#define GPIO_HAL_H
+
+#include "TM4C123GH6PM.h"
+
+// Bus aperture of each GPIO port, chosen at build time. Set a port to 1 to access
+// it through the Advanced High-Performance Bus (AHB) aperture or to 0 to use the
+// legacy Advanced Peripheral Bus (APB) aperture. The AHB aperture allows back-to-back
+// accesses every clock cycle, which speeds up the LCD and LED bit toggling.
+// A port must only be accessed through the aperture selected in GPIOHBCTL
+#ifndef GPIO_PORTA_USE_AHB
+#define GPIO_PORTA_USE_AHB 1
+#endif
+
+#ifndef GPIO_PORTB_USE_AHB
+#define GPIO_PORTB_USE_AHB 1
+#endif
+
+#ifndef GPIO_PORTC_USE_AHB
+#define GPIO_PORTC_USE_AHB 1
+#endif
+
+#ifndef GPIO_PORTD_USE_AHB
+#define GPIO_PORTD_USE_AHB 1
+#endif
+
+#ifndef GPIO_PORTE_USE_AHB
+#define GPIO_PORTE_USE_AHB 1
+#endif
+
+#ifndef GPIO_PORTF_USE_AHB
+#define GPIO_PORTF_USE_AHB 1
+#endif
+
+#define GPIO_PORTA_BASE (GPIO_PORTA_USE_AHB ? GPIOA_AHB_BASE : GPIOA_BASE)
+#define GPIO_PORTB_BASE (GPIO_PORTB_USE_AHB ? GPIOB_AHB_BASE : GPIOB_BASE)
+#define GPIO_PORTC_BASE (GPIO_PORTC_USE_AHB ? GPIOC_AHB_BASE : GPIOC_BASE)
+#define GPIO_PORTD_BASE (GPIO_PORTD_USE_AHB ? GPIOD_AHB_BASE : GPIOD_BASE)
+#define GPIO_PORTE_BASE (GPIO_PORTE_USE_AHB ? GPIOE_AHB_BASE : GPIOE_BASE)
+#define GPIO_PORTF_BASE (GPIO_PORTF_USE_AHB ? GPIOF_AHB_BASE : GPIOF_BASE)
+
+// Register blocks of the ports through the selected aperture. Both apertures share the same layout
+#define GPIO_PORTA ((GPIOA_Type *) GPIO_PORTA_BASE)
+#define GPIO_PORTB ((GPIOA_Type *) GPIO_PORTB_BASE)
+#define GPIO_PORTC ((GPIOA_Type *) GPIO_PORTC_BASE)
+#define GPIO_PORTD ((GPIOA_Type *) GPIO_PORTD_BASE)
+#define GPIO_PORTE ((GPIOA_Type *) GPIO_PORTE_BASE)
+#define GPIO_PORTF ((GPIOA_Type *) GPIO_PORTF_BASE)
+
+// GPIOHBCTL bits of the ports that use the AHB aperture (Bit 0 = Port A)
+#define GPIO_AHB_PORT_MASK                  \
+	((GPIO_PORTA_USE_AHB << 0) |            \
+	 (GPIO_PORTB_USE_AHB << 1) |            \
+	 (GPIO_PORTC_USE_AHB << 2) |            \
+	 (GPIO_PORTD_USE_AHB << 3) |            \
+	 (GPIO_PORTE_USE_AHB << 4) |            \
+	 (GPIO_PORTF_USE_AHB << 5))
+
+/**
+ * @brief Masked GPIODATA address of a group of pins.
+ *
+ * @param port_base The base address of the GPIO port (e.g. GPIO_PORTA_BASE).
+ *
+ * @param mask The pins of the group (Bit 0 = Pin 0).
+ */
+#define GPIO_DATA_ALIAS(port_base, mask) \
+	((volatile uint32_t *)((uint32_t)(port_base) + ((uint32_t)(mask) << 2)))
+
+/**
+ * @brief Initializer for a GPIO_Pin_Group descriptor.
+ *
+ * Example: static const GPIO_Pin_Group leds = GPIO_PIN_GROUP(GPIO_PORTB_BASE, 0x0F);
+ */
+#define GPIO_PIN_GROUP(port_base, mask) { GPIO_DATA_ALIAS(port_base, mask), (mask) }
+
+typedef struct
+{
+	volatile uint32_t* data;
+	uint8_t mask;
+} GPIO_Pin_Group;
+
+/**
+ * @brief Selects the bus aperture of every GPIO port in the GPIOHBCTL register.
+ *
+ * This function must be called before a driver accesses its port registers.
+ * It can safely be called by every driver since it only sets the configured bits.
+ *
+ * @param None
+ *
+ * @return None
+ */
+static inline void GPIO_Bus_Init(void)
+{
+	SYSCTL->GPIOHBCTL |= GPIO_AHB_PORT_MASK;
+}
+
+/**
+ * @brief Writes the pins of a group with a single store.
+ *
+ * Bits of value outside of the group's mask are ignored by the hardware.
+ *
+ * @param group The pin group descriptor.
+ *
+ * @param value The pin levels, aligned to the port's bit positions.
+ *
+ * @return None
+ */
+static inline void GPIO_Pin_Group_Write(const GPIO_Pin_Group* group, uint8_t value)
+{
+	*group->data = value;
+}
+
+/**
+ * @brief Drives every pin of a group high.
+ *
+ * @param group The pin group descriptor.
+ *
+ * @return None
+ */
+static inline void GPIO_Pin_Group_Set(const GPIO_Pin_Group* group)
+{
+	*group->data = 0xFF;
+}
+
+/**
+ * @brief Drives every pin of a group low.
+ *
+ * @param group The pin group descriptor.
+ *
+ * @return None
+ */
+static inline void GPIO_Pin_Group_Clear(const GPIO_Pin_Group* group)
+{
+	*group->data = 0x00;
+}
+
+/**
+ * @brief Reads the pins of a group.
+ *
+ * @param group The pin group descriptor.
+ *
+ * @return The pin levels aligned to the port's bit positions. Pins outside of the group read as zero.
+ */
+static inline uint8_t GPIO_Pin_Group_Read(const GPIO_Pin_Group* group)
+{
+	return (uint8_t)*group->data;
+}
+
+/**
+ * @brief Inverts every pin of a group.
+ *
+ * The read and the write only touch the pins of the group,
+ * so other pins of the port are never written.
+ *
+ * @param group The pin group descriptor.
+ *
+ * @return None
+ */
+static inline void GPIO_Pin_Group_Toggle(const GPIO_Pin_Group* group)
+{
+	*group->data = ~(*group->data);
+}
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file Hib_RTC.c
+ * @brief Hibernation module RTC: counters, match interrupt and DATA words.
+ */
+
+#include "Hib_RTC.h"
+#include "Clock.h"
+#include "Profile.h"
+#include "TM4C123GH6PM.h"
+#include <stddef.h>
+
+// HIBCTL bits
+#define HIB_CTL_RTCEN    0x00000001
+#define HIB_CTL_CLK32EN  0x00000040
+#define HIB_CTL_WRC      0x80000000
+
+// HIBIM / HIBRIS / HIBIC bits
+#define HIB_INT_RTCALT0  0x00000001
+
+// HIBRTCSS subseconds counter field
+#define HIB_RTCSS_RTCSSC 0x00007FFF
+
+// HIBRTCT value for an untrimmed 64th second, and the subsecond counts per 64 s
+#define HIB_RTCT_NOMINAL 0x7FFF
+#define HIB_RTCT_COUNTS_PER_TRIM (64LL * HIB_RTC_SUBSECONDS_HZ)
+
+// ==============================
+// Register Access
+// ==============================
+
+// Waits until the Hibernation module accepts another write
+static void Hib_RTC_Wait_Write(void)
+{
+    while (!(HIB->CTL & HIB_CTL_WRC));
+}
+
+static void Hib_RTC_Write(volatile uint32_t* reg, uint32_t value)
+{
+    Hib_RTC_Wait_Write();
+    *reg = value;
+}
+
+// ==============================
+// Initialization
+// ==============================
+uint8_t Hib_RTC_Init(void)
+{
+    // Enable the Hibernation module clock and wait until it is ready
+    SYSCTL->RCGCHIB |= 0x01;
+    while (!(SYSCTL->PRHIB & 0x01));
+
+    if ((HIB->CTL & (HIB_CTL_CLK32EN | HIB_CTL_RTCEN)) == (HIB_CTL_CLK32EN | HIB_CTL_RTCEN))
+    {
+        return 1;
+    }
+
+    // WRC is only valid once the 32 kHz oscillator is enabled, so this first write does not wait
+    HIB->CTL |= HIB_CTL_CLK32EN;
+    Hib_RTC_Wait_Write();
+
+    Hib_RTC_Write(&HIB->RTCLD, 0);
+    Hib_RTC_Write(&HIB->CTL, HIB->CTL | HIB_CTL_RTCEN);
+    Hib_RTC_Wait_Write();
+
+    return 0;
+}
+
+// ==============================
+// Counters
+// ==============================
+uint32_t Hib_RTC_Read(uint32_t* subseconds)
+{
+    uint32_t seconds;
+    uint32_t ss;
+
+    // Read again if the seconds counter rolled over between the two reads
+    do
+    {
+        seconds = HIB->RTCC;
+        ss = HIB->RTCSS & HIB_RTCSS_RTCSSC;
+    } while (seconds != HIB->RTCC);
+
+    if (subseconds != NULL)
+    {
+        *subseconds = ss;
+    }
+    return seconds;
+}
+
+void Hib_RTC_Load(uint32_t seconds)
+{
+    Hib_RTC_Write(&HIB->RTCLD, seconds);
+    Hib_RTC_Wait_Write();
+}
+
+void Hib_RTC_Set_Match(uint32_t seconds)
+{
+    Hib_RTC_Write(&HIB->RTCM0, seconds);
+    Hib_RTC_Wait_Write();
+}
+
+void Hib_RTC_Enable_Match_Interrupt(void)
+{
+    Hib_RTC_Write(&HIB->IC, HIB_INT_RTCALT0);
+    Hib_RTC_Write(&HIB->IM, HIB->IM | HIB_INT_RTCALT0);
+    Hib_RTC_Wait_Write();
+
+    NVIC_EnableIRQ(HIB_IRQn);
+}
+
+void Hib_RTC_Set_Trim_ppb(int32_t trim_ppb)
+{
+    // Subsecond counts to add to every 64th second, rounded to the nearest count
+    int64_t scaled = (int64_t)trim_ppb * HIB_RTCT_COUNTS_PER_TRIM;
+    int64_t counts = (scaled + (scaled >= 0 ? 500000000LL : -500000000LL)) / 1000000000LL;
+
+    Hib_RTC_Write(&HIB->RTCT, (uint32_t)(HIB_RTCT_NOMINAL + counts) & 0xFFFF);
+    Hib_RTC_Wait_Write();
+}
+
+// ==============================
+// Battery-Backed Memory
+// ==============================
+uint32_t Hib_RTC_Read_Data(uint8_t index)
+{
+    return (&HIB->DATA)[index];
+}
+
+void Hib_RTC_Write_Data(uint8_t index, uint32_t value)
+{
+    Hib_RTC_Write(&(&HIB->DATA)[index], value);
+}
+
+// ==============================
+// Interrupt Handler
+// ==============================
+void HIB_Handler(void)
+{
+    PROFILE_BEGIN(PROFILE_HIB_ISR);
+
+    // The clear has to complete before returning, or the interrupt fires again
+    Hib_RTC_Write(&HIB->IC, HIB_INT_RTCALT0);
+    Hib_RTC_Wait_Write();
+
+    Clock_Tick();
+
+    PROFILE_END(PROFILE_HIB_ISR);
+}
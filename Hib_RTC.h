@@ -0,0 +1,93 @@
+/**
+ * @file Hib_RTC.h
+ *
+ * @brief Interface for the Hibernation module's real-time clock.
+ *
+ * The RTC counts seconds (RTCC) and 1/32768 s subseconds (RTCSS) from the
+ * 32.768 kHz crystal on XOSC0/XOSC1. The Hibernation module keeps its own
+ * power domain, so the counters and the 16 battery-backed DATA words survive
+ * a reset of the core as long as VBAT is powered.
+ *
+ * Writes to the Hibernation registers take up to three 32 kHz cycles; every
+ * write waits for the previous one to complete (HIBCTL.WRC).
+ *
+ * The match interrupt (RTCC == RTCM0) calls Clock_Tick.
+ */
+#ifndef HIB_RTC_H
+#define HIB_RTC_H
+
+#include <stdint.h>
+
+// Number of battery-backed DATA words
+#define HIB_RTC_DATA_WORDS 16
+
+// Subsecond counts per second
+#define HIB_RTC_SUBSECONDS_HZ 32768
+
+/**
+ * @brief Enables the Hibernation module clock and starts the RTC if needed.
+ *
+ * An RTC that is already running is left alone, so the time kept across a
+ * reset is not lost.
+ *
+ * @return 1 if the RTC was already running, 0 if it was just started from 0.
+ */
+uint8_t Hib_RTC_Init(void);
+
+/**
+ * @brief Reads the seconds and subseconds counters as one value.
+ *
+ * @param subseconds Receives the subseconds (0 to 32767), or NULL.
+ * @return The seconds counter.
+ */
+uint32_t Hib_RTC_Read(uint32_t* subseconds);
+
+/**
+ * @brief Loads the seconds counter and clears the subseconds counter.
+ */
+void Hib_RTC_Load(uint32_t seconds);
+
+/**
+ * @brief Sets the seconds value at which the match interrupt fires.
+ */
+void Hib_RTC_Set_Match(uint32_t seconds);
+
+/**
+ * @brief Enables the match interrupt in the Hibernation module and the NVIC.
+ */
+void Hib_RTC_Enable_Match_Interrupt(void);
+
+/**
+ * @brief Trims the RTC rate through the RTCT register.
+ *
+ * Every 64th second is lengthened or shortened by whole subsecond counts,
+ * so the resolution is 1 / (64 * 32768) s/s, about 0.48 ppm, and the trim
+ * only shows over windows of 64 s or more.
+ *
+ * @param trim_ppb Crystal error in parts per billion; positive if the crystal runs fast.
+ */
+void Hib_RTC_Set_Trim_ppb(int32_t trim_ppb);
+
+/**
+ * @brief Reads one of the battery-backed DATA words.
+ *
+ * @param index Word index (0 to HIB_RTC_DATA_WORDS - 1).
+ */
+uint32_t Hib_RTC_Read_Data(uint8_t index);
+
+/**
+ * @brief Writes one of the battery-backed DATA words.
+ *
+ * @param index Word index (0 to HIB_RTC_DATA_WORDS - 1).
+ * @param value Value to keep.
+ */
+void Hib_RTC_Write_Data(uint8_t index, uint32_t value);
+
+/**
+ * @brief Hibernation interrupt handler.
+ *
+ * Clears the match interrupt and calls Clock_Tick.
+ */
+void HIB_Handler(void);
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file Light_Sensor.c
+ * @brief Filtered, hysteretic light sensor dismiss with an ambient baseline.
+ */
+
+#include "Light_Sensor.h"
+
+// Results taken from the ring buffer per read
+#define LIGHT_SENSOR_BATCH 8
+
+// Filtered value and baseline, scaled by their shifts to keep the fraction
+static uint32_t filtered_scaled = 0;
+static uint32_t baseline_scaled = 0;
+static bool primed = false;
+
+// Thresholds of the armed sensor in counts. Both 0 while disarmed
+static uint16_t enter_threshold = 0;
+static uint16_t exit_threshold = 0;
+
+static bool armed = false;
+static bool covered = false;
+static bool dismiss_pending = false;
+static uint16_t dwell_samples = 1;
+static uint16_t covered_samples = 0;
+
+// ==============================
+// Initialization
+// ==============================
+void Light_Sensor_Init(void)
+{
+    filtered_scaled = 0;
+    baseline_scaled = 0;
+    primed = false;
+    enter_threshold = 0;
+    exit_threshold = 0;
+    armed = false;
+    covered = false;
+    dismiss_pending = false;
+    covered_samples = 0;
+
+    ADC_Start(LIGHT_SENSOR_IDLE_RATE_HZ);
+}
+
+// ==============================
+// Arming
+// ==============================
+void Light_Sensor_Arm_At(uint32_t rate_hz)
+{
+    uint32_t baseline = baseline_scaled >> LIGHT_SENSOR_BASELINE_SHIFT;
+
+    // Too dark to see the sensor being covered: thresholds of 0 never match
+    if (baseline < LIGHT_SENSOR_MIN_BASELINE)
+    {
+        enter_threshold = 0;
+        exit_threshold = 0;
+    }
+    else
+    {
+        enter_threshold = (uint16_t)((baseline * LIGHT_SENSOR_ENTER_PERCENT) / 100);
+        exit_threshold = (uint16_t)((baseline * LIGHT_SENSOR_EXIT_PERCENT) / 100);
+    }
+
+    // Round up, so the dwell is never shorter than asked
+    dwell_samples = (uint16_t)(((LIGHT_SENSOR_DWELL_MS * rate_hz) + 999) / 1000);
+    if (dwell_samples == 0)
+    {
+        dwell_samples = 1;
+    }
+
+    armed = true;
+    covered = false;
+    covered_samples = 0;
+    dismiss_pending = false;
+}
+
+void Light_Sensor_Arm(void)
+{
+    Light_Sensor_Arm_At(LIGHT_SENSOR_ACTIVE_RATE_HZ);
+
+#if LIGHT_SENSOR_USE_COMPARATOR
+    // The thresholds are 0 in a room too dark to watch
+    if (enter_threshold != 0)
+    {
+        ADC_Comparator_Start(enter_threshold, exit_threshold, dwell_samples);
+    }
+#endif
+    ADC_Start(LIGHT_SENSOR_ACTIVE_RATE_HZ);
+}
+
+void Light_Sensor_Disarm(void)
+{
+    armed = false;
+    covered = false;
+    covered_samples = 0;
+    dismiss_pending = false;
+    enter_threshold = 0;
+    exit_threshold = 0;
+
+#if LIGHT_SENSOR_USE_COMPARATOR
+    ADC_Comparator_Stop();
+    ADC_Take_Comparator_Event();
+#endif
+    ADC_Start(LIGHT_SENSOR_IDLE_RATE_HZ);
+}
+
+// ==============================
+// Filtering and decision
+// ==============================
+void Light_Sensor_Feed(uint16_t raw)
+{
+    // The first result primes both averages
+    if (!primed)
+    {
+        filtered_scaled = (uint32_t)raw << LIGHT_SENSOR_FILTER_SHIFT;
+        baseline_scaled = (uint32_t)raw << LIGHT_SENSOR_BASELINE_SHIFT;
+        primed = true;
+    }
+    else
+    {
+        filtered_scaled = filtered_scaled - (filtered_scaled >> LIGHT_SENSOR_FILTER_SHIFT) + raw;
+    }
+
+    uint16_t filtered = (uint16_t)(filtered_scaled >> LIGHT_SENSOR_FILTER_SHIFT);
+
+    // Learn the room only while the alarm is idle
+    if (!armed)
+    {
+        baseline_scaled = baseline_scaled - (baseline_scaled >> LIGHT_SENSOR_BASELINE_SHIFT) + filtered;
+        return;
+    }
+
+    // Hysteresis between the enter and exit thresholds
+    if (!covered && (filtered < enter_threshold))
+    {
+        covered = true;
+        covered_samples = 0;
+    }
+    else if (covered && (filtered > exit_threshold))
+    {
+        covered = false;
+    }
+
+    // Dismiss once per cover, after the dwell time
+    if (covered && (covered_samples < dwell_samples))
+    {
+        if (++covered_samples == dwell_samples)
+        {
+            dismiss_pending = true;
+        }
+    }
+}
+
+void Light_Sensor_Service(void)
+{
+    uint16_t samples[LIGHT_SENSOR_BATCH];
+    uint8_t count;
+
+    do
+    {
+        count = ADC_Read_Samples(samples, LIGHT_SENSOR_BATCH);
+        for (uint8_t i = 0; i < count; i++)
+        {
+            Light_Sensor_Feed(samples[i]);
+        }
+    } while (count == LIGHT_SENSOR_BATCH);
+}
+
+// ==============================
+// Queries
+// ==============================
+bool Light_Sensor_Has_Work(void)
+{
+    return ADC_Has_Samples() || ADC_Comparator_Has_Event() || dismiss_pending;
+}
+
+bool Light_Sensor_Take_Dismiss(void)
+{
+    if (ADC_Take_Comparator_Event())
+    {
+        return true;
+    }
+
+    if (!dismiss_pending)
+    {
+        return false;
+    }
+
+    dismiss_pending = false;
+    return true;
+}
+
+bool Light_Sensor_Is_Covered(void)
+{
+    return covered;
+}
+
+uint16_t Light_Sensor_Get_Filtered(void)
+{
+    return (uint16_t)(filtered_scaled >> LIGHT_SENSOR_FILTER_SHIFT);
+}
+
+uint16_t Light_Sensor_Get_Baseline(void)
+{
+    return (uint16_t)(baseline_scaled >> LIGHT_SENSOR_BASELINE_SHIFT);
+}
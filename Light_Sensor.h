@@ -0,0 +1,128 @@
+/**
+ * @file Light_Sensor.h
+ *
+ * @brief Interface for dismissing the alarm by covering the light sensor.
+ *
+ * Every raw result of the light sensor (already averaged over 16
+ * conversions by the ADC hardware) goes through an exponential moving
+ * average. While the alarm is idle the sensor is sampled slowly and a much
+ * slower average of the filtered value learns the ambient light of the
+ * room. When the alarm rings the baseline is frozen and the sensor is
+ * sampled quickly.
+ *
+ * The sensor counts as covered once the filtered value falls below
+ * LIGHT_SENSOR_ENTER_PERCENT of the baseline, and as uncovered again only
+ * above LIGHT_SENSOR_EXIT_PERCENT. The alarm is dismissed when the sensor
+ * stays covered for LIGHT_SENSOR_DWELL_MS, so a noisy result or a passing
+ * shadow does not dismiss it. In a room darker than
+ * LIGHT_SENSOR_MIN_BASELINE a covered sensor cannot be told apart from the
+ * room, and only SW4 dismisses the alarm (see main.c).
+ *
+ * With LIGHT_SENSOR_USE_COMPARATOR set, the armed sensor is watched by the
+ * ADC digital comparator instead, with the same thresholds and dwell time.
+ * The comparator replaces the software filter with the hardware averaging
+ * alone, and the CPU is not woken while the sensor is lit.
+ *
+ * Light_Sensor_Feed holds all of the software decision logic and touches
+ * no hardware, so recorded traces can be replayed through it.
+ */
+#ifndef LIGHT_SENSOR_H
+#define LIGHT_SENSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ADC.h"
+
+// Watch the armed sensor with the ADC digital comparator (1) or in software (0)
+#ifndef LIGHT_SENSOR_USE_COMPARATOR
+#define LIGHT_SENSOR_USE_COMPARATOR 1
+#endif
+
+// Sampling rates while learning the baseline and while the alarm rings
+#define LIGHT_SENSOR_IDLE_RATE_HZ   1
+#define LIGHT_SENSOR_ACTIVE_RATE_HZ ADC_SAMPLE_RATE_HZ
+
+// Weight of a new result in the filtered value: 1 / 2^LIGHT_SENSOR_FILTER_SHIFT
+#define LIGHT_SENSOR_FILTER_SHIFT 2
+
+// Weight of a filtered value in the baseline: 1 / 2^LIGHT_SENSOR_BASELINE_SHIFT
+#define LIGHT_SENSOR_BASELINE_SHIFT 5
+
+// Covered below this share of the baseline, uncovered above the exit share
+#define LIGHT_SENSOR_ENTER_PERCENT 40
+#define LIGHT_SENSOR_EXIT_PERCENT  60
+
+// Time the sensor must stay covered to dismiss the alarm
+#define LIGHT_SENSOR_DWELL_MS 300
+
+// Darkest baseline in which covering the sensor can be detected
+#define LIGHT_SENSOR_MIN_BASELINE ADC_MV_TO_COUNTS(150)
+
+/**
+ * @brief Clears the filter and the baseline and starts sampling at the idle rate.
+ *
+ * ADC_Init must be called first.
+ */
+void Light_Sensor_Init(void);
+
+/**
+ * @brief Freezes the baseline, sets the thresholds and samples at the active rate.
+ *
+ * Called when the alarm starts ringing.
+ */
+void Light_Sensor_Arm(void);
+
+/**
+ * @brief Returns to learning the baseline at the idle rate.
+ *
+ * Called when the alarm is dismissed or turned off.
+ */
+void Light_Sensor_Disarm(void);
+
+/**
+ * @brief Sets the thresholds from the baseline without touching the ADC.
+ *
+ * Used by Light_Sensor_Arm and to replay traces.
+ *
+ * @param rate_hz Rate at which results will be fed, for the dwell time.
+ */
+void Light_Sensor_Arm_At(uint32_t rate_hz);
+
+/**
+ * @brief Runs one raw result through the filter, baseline and dismiss logic.
+ *
+ * @param raw Result of the light sensor (0 to 4095).
+ */
+void Light_Sensor_Feed(uint16_t raw);
+
+/**
+ * @brief Feeds every result waiting in the ADC ring buffer. Called from the main loop.
+ */
+void Light_Sensor_Service(void);
+
+/**
+ * @brief Returns true if there are results to feed or a dismiss to take.
+ */
+bool Light_Sensor_Has_Work(void);
+
+/**
+ * @brief Returns true once after the sensor has stayed covered for the dwell time while armed.
+ */
+bool Light_Sensor_Take_Dismiss(void);
+
+/**
+ * @brief Returns whether the sensor currently counts as covered.
+ */
+bool Light_Sensor_Is_Covered(void);
+
+/**
+ * @brief Returns the filtered result (0 to 4095).
+ */
+uint16_t Light_Sensor_Get_Filtered(void);
+
+/**
+ * @brief Returns the ambient baseline (0 to 4095).
+ */
+uint16_t Light_Sensor_Get_Baseline(void);
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file Power.c
+ * @brief WFI-based idle and sleeping delays with sleep accounting.
+ *
+ * The core only uses Sleep mode, so the timebase and every peripheral keep
+ * running and any enabled interrupt wakes it. WFI wakes on a pending
+ * interrupt even with PRIMASK set, which lets the work check and the
+ * WFI run in one critical section.
+ */
+
+#include "Power.h"
+#include "Soft_Timer.h"
+#include "TM4C123GH6PM.h"
+#include <stddef.h>
+
+static uint8_t power_ready = 0;
+static uint64_t start_cycles = 0;
+static uint64_t asleep_cycles = 0;
+
+// Keeps the 1 ms tick running while a delay sleeps, so the core wakes in time
+static Soft_Timer delay_wake_timer;
+
+// ==============================
+// Initialization
+// ==============================
+void Power_Init(void)
+{
+    Soft_Timer_Setup(&delay_wake_timer, SOFT_TIMER_DOMAIN_FAST, NULL, NULL);
+
+    start_cycles = SysTick_Now_Cycles();
+    asleep_cycles = 0;
+    power_ready = 1;
+}
+
+// ==============================
+// Sleep (interrupts masked)
+// ==============================
+static void Power_Sleep(void)
+{
+    uint64_t sleep_start = SysTick_Now_Cycles();
+
+    // Make sure every write is done before the core stops
+    __DSB();
+    __WFI();
+
+    asleep_cycles += SysTick_Now_Cycles() - sleep_start;
+}
+
+// ==============================
+// Idle and Delays
+// ==============================
+void Power_Idle(Power_Work_Check work_pending)
+{
+    __disable_irq();
+
+    if (!work_pending())
+    {
+        Power_Sleep();
+    }
+
+    // The interrupt that woke the core runs here
+    __enable_irq();
+}
+
+void Power_Sleep_Until(const SysTick_Deadline* deadline)
+{
+    if (!power_ready || (__get_IPSR() != 0) || (__get_PRIMASK() != 0))
+    {
+        while (!SysTick_Deadline_Expired(deadline));
+        return;
+    }
+
+    Soft_Timer_Start(&delay_wake_timer, 1, 1);
+
+    while (1)
+    {
+        __disable_irq();
+
+        if (SysTick_Deadline_Expired(deadline))
+        {
+            __enable_irq();
+            break;
+        }
+
+        Power_Sleep();
+        __enable_irq();
+    }
+
+    Soft_Timer_Cancel(&delay_wake_timer);
+}
+
+// ==============================
+// Statistics
+// ==============================
+void Power_Get_Cycles(uint64_t* asleep, uint64_t* awake)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint64_t total = SysTick_Now_Cycles() - start_cycles;
+    *asleep = asleep_cycles;
+
+    __set_PRIMASK(primask);
+
+    *awake = total - *asleep;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file Power.h
+ *
+ * @brief Interface for the low-power idle of the main loop.
+ *
+ * The main loop calls Power_Idle at the end of every pass. The core sleeps
+ * (WFI) until the next interrupt unless work is pending. The work check runs
+ * with interrupts masked, so an interrupt that makes work pending right
+ * before the WFI still wakes the core instead of being missed.
+ *
+ * Long blocking delays also sleep, woken every millisecond by the fast
+ * software timer tick. Cycles spent asleep and awake are counted on the
+ * timebase (SysTick_Delay.h) for profiling.
+ */
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include "SysTick_Delay.h"
+
+// Delays shorter than this spin instead of sleeping
+#define POWER_SLEEP_MIN_US 2000
+
+// Returns 1 if the main loop has work to do. Called with interrupts masked
+typedef uint8_t (*Power_Work_Check)(void);
+
+/**
+ * @brief Enables sleeping in delays and starts the cycle counters.
+ *
+ * Soft_Timer_Init must be called first. Delays before Power_Init spin.
+ */
+void Power_Init(void);
+
+/**
+ * @brief Sleeps until the next interrupt unless work is pending.
+ *
+ * @param work_pending Checks for pending work; called with interrupts masked.
+ */
+void Power_Idle(Power_Work_Check work_pending);
+
+/**
+ * @brief Blocks until a deadline, sleeping between the 1 ms fast ticks.
+ *
+ * Spins instead when called before Power_Init, from an interrupt handler,
+ * or with interrupts masked, since no interrupt could wake the core.
+ *
+ * @param deadline The deadline to wait for.
+ */
+void Power_Sleep_Until(const SysTick_Deadline* deadline);
+
+/**
+ * @brief Returns the system clock cycles spent asleep and awake since Power_Init.
+ *
+ * @param asleep Cycles spent in WFI.
+ * @param awake  All other cycles.
+ */
+void Power_Get_Cycles(uint64_t* asleep, uint64_t* awake);
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file Profile.c
+ * @brief Probe statistics on top of the DWT cycle counter.
+ *
+ * CYCCNT wraps every 2^32 cycles (53 s at 80 MHz). A probe only subtracts
+ * two readings, so sections shorter than that are measured correctly.
+ */
+
+#include "Profile.h"
+
+#if PROFILE_ENABLED
+
+#include "Format.h"
+#include "SysClock.h"
+
+static Profile_Stats probes[PROFILE_PROBE_COUNT];
+
+static const char* const probe_names[PROFILE_PROBE_COUNT] = {
+    "TIMER0A ISR",
+    "TIMER1A ISR",
+    "TIMER2A ISR",
+    "TIMER4A ISR",
+    "ADC0SS0 ISR",
+    "GPIOD ISR",
+    "HIB ISR",
+    "TIMEBASE ISR",
+    "UpdateTime",
+    "Refresh",
+    "ShadowCommit",
+    "ADC_Sample",
+    "ADC_Read",
+    "Loop pass",
+    "Loop timers",
+    "Loop logic",
+};
+
+// ==============================
+// Initialization
+// ==============================
+void Profile_Init(void)
+{
+    // Enable the trace block, then start the cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Profile_Reset();
+}
+
+void Profile_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++)
+    {
+        Profile_Stats* stats = &probes[i];
+        stats->count = 0;
+        stats->min = UINT32_MAX;
+        stats->max = 0;
+        stats->total = 0;
+        for (uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+        {
+            stats->histogram[bin] = 0;
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+// ==============================
+// Recording
+// ==============================
+void Profile_Record(Profile_Probe probe, uint32_t cycles)
+{
+    Profile_Stats* stats = &probes[probe];
+
+    // Bin of the highest set bit; 0 and 1 cycle share bin 0
+    uint8_t bin = (cycles == 0) ? 0 : (uint8_t)(31 - __CLZ(cycles));
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    stats->count++;
+    stats->total += cycles;
+    if (cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    stats->histogram[bin]++;
+
+    __set_PRIMASK(primask);
+}
+
+// ==============================
+// Queries
+// ==============================
+const Profile_Stats* Profile_Get_Stats(Profile_Probe probe)
+{
+    return &probes[probe];
+}
+
+const char* Profile_Get_Name(Profile_Probe probe)
+{
+    return probe_names[probe];
+}
+
+uint32_t Profile_Get_Mean(Profile_Probe probe)
+{
+    const Profile_Stats* stats = &probes[probe];
+
+    if (stats->count == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(stats->total / stats->count);
+}
+
+// ==============================
+// Dump
+// ==============================
+void Profile_Dump(Profile_Writer writer)
+{
+    for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++)
+    {
+        const Profile_Stats* stats = &probes[i];
+
+        if (stats->count == 0)
+        {
+            continue;
+        }
+
+        char line[36];
+        uint8_t length = 0;
+
+        length += Format_Unsigned(&line[length], stats->min / SYSCLOCK_CYCLES_PER_US);
+        line[length++] = '/';
+        length += Format_Unsigned(&line[length], Profile_Get_Mean((Profile_Probe)i) / SYSCLOCK_CYCLES_PER_US);
+        line[length++] = '/';
+        Format_Unsigned(&line[length], stats->max / SYSCLOCK_CYCLES_PER_US);
+
+        writer(probe_names[i], line);
+    }
+}
+
+#endif
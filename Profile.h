@@ -0,0 +1,126 @@
+/**
+ * @file Profile.h
+ *
+ * @brief Interface for cycle-count profiling with the DWT cycle counter.
+ *
+ * Named probes measure a section of code in system clock cycles:
+ *
+ *     PROFILE_BEGIN(PROFILE_DISPLAY_REFRESH);
+ *     ...
+ *     PROFILE_END(PROFILE_DISPLAY_REFRESH);
+ *
+ * Each probe keeps the count, minimum, maximum and mean of its samples and
+ * a histogram with one bin per power of two. Probes can be used from
+ * interrupt handlers. A probe around code that is interrupted includes the
+ * cycles of the interrupt handler.
+ *
+ * Profiling is off unless PROFILE_ENABLED is set to 1 in the project's
+ * preprocessor symbols. When it is off, the probes expand to nothing and
+ * no profiling code or data is built.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+// Probes, grouped by interrupt handlers, driver entry points and main loop phases
+typedef enum {
+    PROFILE_TIMER0A_ISR,
+    PROFILE_TIMER1A_ISR,
+    PROFILE_TIMER2A_ISR,
+    PROFILE_TIMER4A_ISR,
+    PROFILE_ADC0SS0_ISR,
+    PROFILE_GPIOD_ISR,
+    PROFILE_HIB_ISR,
+    PROFILE_TIMEBASE_ISR,
+    PROFILE_DISPLAY_UPDATE_TIME,
+    PROFILE_DISPLAY_REFRESH,
+    PROFILE_LCD_SHADOW_COMMIT,
+    PROFILE_ADC_SAMPLE,
+    PROFILE_ADC_READ,
+    PROFILE_LOOP_PASS,
+    PROFILE_LOOP_TIMERS,
+    PROFILE_LOOP_LOGIC,
+    PROFILE_PROBE_COUNT
+} Profile_Probe;
+
+// One histogram bin per power of two of a 32-bit cycle count
+#define PROFILE_HISTOGRAM_BINS 32
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[PROFILE_HISTOGRAM_BINS];  // Bin n counts samples of 2^n to 2^(n+1) - 1 cycles
+} Profile_Stats;
+
+// Receives one line of a dump: the probe name and its statistics
+typedef void (*Profile_Writer)(const char* name, const char* line);
+
+#if PROFILE_ENABLED
+
+#include "TM4C123GH6PM.h"
+
+#define PROFILE_BEGIN(probe)  const uint32_t profile_start_##probe = DWT->CYCCNT
+#define PROFILE_END(probe)    Profile_Record((probe), DWT->CYCCNT - profile_start_##probe)
+
+/**
+ * @brief Starts the DWT cycle counter and clears every probe.
+ */
+void Profile_Init(void);
+
+/**
+ * @brief Clears the statistics of every probe.
+ */
+void Profile_Reset(void);
+
+/**
+ * @brief Adds one sample to a probe. Used by PROFILE_END.
+ *
+ * @param probe  The probe.
+ * @param cycles Length of the measured section in system clock cycles.
+ */
+void Profile_Record(Profile_Probe probe, uint32_t cycles);
+
+/**
+ * @brief Returns the statistics of a probe.
+ */
+const Profile_Stats* Profile_Get_Stats(Profile_Probe probe);
+
+/**
+ * @brief Returns the short name of a probe.
+ */
+const char* Profile_Get_Name(Profile_Probe probe);
+
+/**
+ * @brief Returns the mean cycle count of a probe, or 0 without samples.
+ */
+uint32_t Profile_Get_Mean(Profile_Probe probe);
+
+/**
+ * @brief Writes one line per probe with samples.
+ *
+ * The line holds the minimum, mean and maximum in microseconds as
+ * "min/mean/max", which fits the 16 columns of the LCD.
+ *
+ * @param writer Called once per probe, e.g. to show it on the LCD or send it over serial.
+ */
+void Profile_Dump(Profile_Writer writer);
+
+#else
+
+#define PROFILE_BEGIN(probe)  ((void)0)
+#define PROFILE_END(probe)    ((void)0)
+
+#define Profile_Init()        ((void)0)
+#define Profile_Reset()       ((void)0)
+#define Profile_Dump(writer)  ((void)0)
+
+#endif
+
+#endif
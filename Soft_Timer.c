@@ -0,0 +1,362 @@
+/**
+ * @file Soft_Timer.c
+ * @brief Hierarchical timer wheels for the software timer service.
+ *
+ * Each domain has three levels of 64 slots. Level 0 holds the timers that
+ * expire within 64 ticks, one slot per tick. Level 1 slots cover 64 ticks
+ * each and level 2 slots 4096 ticks each. When level 0 wraps, the next
+ * level 1 slot is cascaded (its timers are re-inserted closer to their
+ * expiry), and likewise for level 2. Timers further away than the wheel's
+ * range are parked in the last level 2 slot they can reach and re-inserted
+ * when it cascades.
+ *
+ * List operations run with interrupts masked since timers can be started
+ * from interrupt handlers. Callbacks run with interrupts enabled.
+ *
+ * Timer2A only runs while the fast domain has an active timer.
+ */
+
+#include "Soft_Timer.h"
+#include "Timer.h"
+#include "TM4C123GH6PM.h"
+#include <stddef.h>
+
+// ==============================
+// Wheel Geometry
+// ==============================
+#define WHEEL_LEVELS        3
+#define WHEEL_SLOT_BITS     6
+#define WHEEL_SLOTS         (1UL << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK     (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE         (1UL << (WHEEL_SLOT_BITS * WHEEL_LEVELS))
+
+typedef struct {
+    Soft_Timer_Link slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    volatile uint32_t ticks;    // Ticks counted by the interrupt
+    uint32_t now;               // Last tick processed by Soft_Timer_Service
+} Soft_Timer_Wheel;
+
+static Soft_Timer_Wheel wheels[SOFT_TIMER_DOMAIN_COUNT];
+
+// ==============================
+// Statistics
+// ==============================
+static uint32_t active_count = 0;
+static uint32_t late_count = 0;
+
+// Active timers of each domain; the fast tick is stopped when the fast domain has none
+static uint32_t domain_active_count[SOFT_TIMER_DOMAIN_COUNT];
+
+// Counts a timer in or out of its domain (interrupts masked)
+static void Soft_Timer_Count_Active(uint8_t domain, uint8_t started)
+{
+    if (started)
+    {
+        active_count++;
+        domain_active_count[domain]++;
+        if ((domain == SOFT_TIMER_DOMAIN_FAST) && (domain_active_count[domain] == 1))
+        {
+            Timer2A_Start();
+        }
+    }
+    else
+    {
+        active_count--;
+        domain_active_count[domain]--;
+        if ((domain == SOFT_TIMER_DOMAIN_FAST) && (domain_active_count[domain] == 0))
+        {
+            Timer2A_Stop();
+        }
+    }
+}
+
+// ==============================
+// List Helpers (interrupts masked)
+// ==============================
+static void Soft_Timer_List_Init(Soft_Timer_Link* head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+static void Soft_Timer_List_Append(Soft_Timer_Link* head, Soft_Timer_Link* node)
+{
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+static void Soft_Timer_List_Remove(Soft_Timer_Link* node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = node;
+    node->prev = node;
+}
+
+// Links a timer into the slot that matches its distance from the wheel's current tick
+static void Soft_Timer_Insert(Soft_Timer_Wheel* wheel, Soft_Timer* timer)
+{
+    uint32_t expiry = timer->expiry;
+    uint32_t delta = expiry - wheel->now;
+    Soft_Timer_Link* slot;
+
+    if (delta < WHEEL_SLOTS)
+    {
+        slot = &wheel->slots[0][expiry & WHEEL_SLOT_MASK];
+    }
+    else if (delta < (WHEEL_SLOTS << WHEEL_SLOT_BITS))
+    {
+        slot = &wheel->slots[1][(expiry >> WHEEL_SLOT_BITS) & WHEEL_SLOT_MASK];
+    }
+    else
+    {
+        // Park far timers in the furthest slot; they are re-inserted when it cascades
+        if (delta >= WHEEL_RANGE)
+        {
+            expiry = wheel->now + WHEEL_RANGE - 1;
+        }
+        slot = &wheel->slots[2][(expiry >> (2 * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK];
+    }
+
+    Soft_Timer_List_Append(slot, &timer->link);
+}
+
+// Re-inserts every timer of a level 1 or level 2 slot
+static void Soft_Timer_Cascade(Soft_Timer_Wheel* wheel, uint8_t level, uint32_t index)
+{
+    Soft_Timer_Link* slot = &wheel->slots[level][index];
+
+    while (slot->next != slot)
+    {
+        Soft_Timer_Link* node = slot->next;
+        Soft_Timer_List_Remove(node);
+        Soft_Timer_Insert(wheel, (Soft_Timer*)node);
+    }
+}
+
+// ==============================
+// Initialization
+// ==============================
+void Soft_Timer_Init(void)
+{
+    for (uint8_t domain = 0; domain < SOFT_TIMER_DOMAIN_COUNT; domain++)
+    {
+        for (uint8_t level = 0; level < WHEEL_LEVELS; level++)
+        {
+            for (uint32_t slot = 0; slot < WHEEL_SLOTS; slot++)
+            {
+                Soft_Timer_List_Init(&wheels[domain].slots[level][slot]);
+            }
+        }
+        wheels[domain].ticks = 0;
+        wheels[domain].now = 0;
+        domain_active_count[domain] = 0;
+    }
+
+    active_count = 0;
+    late_count = 0;
+
+    // The seconds domain is ticked by the clock interrupt once the clock starts.
+    // Timer2A is started by the first fast timer
+    Timer2A_Init_1kHz();
+}
+
+void Soft_Timer_Setup(Soft_Timer* timer, Soft_Timer_Domain domain,
+                      Soft_Timer_Callback callback, void* context)
+{
+    Soft_Timer_List_Init(&timer->link);
+    timer->expiry = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->context = context;
+    timer->domain = (uint8_t)domain;
+    timer->active = 0;
+    timer->fired = 0;
+}
+
+// ==============================
+// Start / Cancel
+// ==============================
+void Soft_Timer_Start(Soft_Timer* timer, uint32_t ticks, uint32_t period)
+{
+    Soft_Timer_Wheel* wheel = &wheels[timer->domain];
+
+    // The slot of the tick being processed has already been serviced
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (timer->active)
+    {
+        Soft_Timer_List_Remove(&timer->link);
+    }
+    else
+    {
+        Soft_Timer_Count_Active(timer->domain, 1);
+    }
+
+    // Count from the interrupt's tick so a busy main loop does not shorten the timer
+    timer->expiry = wheel->ticks + ticks;
+    timer->period = period;
+    timer->active = 1;
+    timer->fired = 0;
+    Soft_Timer_Insert(wheel, timer);
+
+    __set_PRIMASK(primask);
+}
+
+void Soft_Timer_Cancel(Soft_Timer* timer)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (timer->active)
+    {
+        Soft_Timer_List_Remove(&timer->link);
+        timer->active = 0;
+        Soft_Timer_Count_Active(timer->domain, 0);
+    }
+    timer->fired = 0;
+
+    __set_PRIMASK(primask);
+}
+
+uint8_t Soft_Timer_Is_Active(const Soft_Timer* timer)
+{
+    return timer->active;
+}
+
+uint8_t Soft_Timer_Take_Fired(Soft_Timer* timer)
+{
+    if (!timer->fired)
+    {
+        return 0;
+    }
+
+    timer->fired = 0;
+    return 1;
+}
+
+// ==============================
+// Tick Processing
+// ==============================
+void Soft_Timer_Tick(Soft_Timer_Domain domain)
+{
+    wheels[domain].ticks++;
+}
+
+static void Soft_Timer_Process_Tick(Soft_Timer_Wheel* wheel)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t tick = wheel->now + 1;
+    wheel->now = tick;
+
+    // Bring the timers of the next 64-tick block down to level 0
+    if ((tick & WHEEL_SLOT_MASK) == 0)
+    {
+        if (((tick >> WHEEL_SLOT_BITS) & WHEEL_SLOT_MASK) == 0)
+        {
+            Soft_Timer_Cascade(wheel, 2, (tick >> (2 * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK);
+        }
+        Soft_Timer_Cascade(wheel, 1, (tick >> WHEEL_SLOT_BITS) & WHEEL_SLOT_MASK);
+    }
+
+    __set_PRIMASK(primask);
+
+    // Timers added to the wheel by the callbacks never land in this slot,
+    // so the slot can be drained one timer at a time
+    Soft_Timer_Link* slot = &wheel->slots[0][tick & WHEEL_SLOT_MASK];
+
+    while (1)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if (slot->next == slot)
+        {
+            __set_PRIMASK(primask);
+            break;
+        }
+
+        Soft_Timer* timer = (Soft_Timer*)slot->next;
+        Soft_Timer_List_Remove(&timer->link);
+
+        if (wheel->ticks != tick)
+        {
+            late_count++;
+        }
+
+        // Periodic timers keep their phase: the next expiry is counted from this one
+        if (timer->period != 0)
+        {
+            timer->expiry = timer->expiry + timer->period;
+            Soft_Timer_Insert(wheel, timer);
+        }
+        else
+        {
+            timer->active = 0;
+            Soft_Timer_Count_Active(timer->domain, 0);
+        }
+
+        Soft_Timer_Callback callback = timer->callback;
+        void* context = timer->context;
+
+        if (callback == NULL)
+        {
+            timer->fired = 1;
+        }
+
+        __set_PRIMASK(primask);
+
+        if (callback != NULL)
+        {
+            callback(context);
+        }
+    }
+}
+
+void Soft_Timer_Service(void)
+{
+    for (uint8_t domain = 0; domain < SOFT_TIMER_DOMAIN_COUNT; domain++)
+    {
+        Soft_Timer_Wheel* wheel = &wheels[domain];
+
+        while (wheel->now != wheel->ticks)
+        {
+            Soft_Timer_Process_Tick(wheel);
+        }
+    }
+}
+
+uint8_t Soft_Timer_Has_Pending_Ticks(void)
+{
+    for (uint8_t domain = 0; domain < SOFT_TIMER_DOMAIN_COUNT; domain++)
+    {
+        if (wheels[domain].now != wheels[domain].ticks)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ==============================
+// Statistics
+// ==============================
+uint32_t Soft_Timer_Get_Active_Count(void)
+{
+    return active_count;
+}
+
+uint32_t Soft_Timer_Get_Late_Count(void)
+{
+    return late_count;
+}
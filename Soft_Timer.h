@@ -0,0 +1,139 @@
+/**
+ * @file Soft_Timer.h
+ *
+ * @brief Interface for the software timer service.
+ *
+ * Software timers count ticks of one of two domains:
+ *  - SOFT_TIMER_DOMAIN_FAST:    1 ms ticks from the Timer2A interrupt,
+ *                               which only runs while a fast timer is active
+ *  - SOFT_TIMER_DOMAIN_SECONDS: 1 s ticks from the clock interrupt
+ *                               (Timer0A or the RTC match, see Clock.h)
+ *
+ * Each domain keeps its timers in a hierarchical timer wheel (three levels of
+ * 64 slots), so starting and cancelling a timer is O(1) and a tick only
+ * touches one slot. Expiry times are absolute, so a main loop that falls
+ * behind fires the timers late but never shortens or stretches a countdown.
+ *
+ * The interrupts only count ticks. Soft_Timer_Service, called from the main
+ * loop, advances the wheels and delivers expirations either by calling the
+ * timer's callback or by setting its fired flag (see Soft_Timer_Take_Fired).
+ * Timers can be started and cancelled from interrupt handlers.
+ */
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include <stdint.h>
+
+// Tick rate of the fast domain (Timer2A)
+#define SOFT_TIMER_FAST_TICK_HZ 1000
+
+// Tick sources
+typedef enum {
+    SOFT_TIMER_DOMAIN_FAST,     // 1 ms ticks
+    SOFT_TIMER_DOMAIN_SECONDS,  // 1 s ticks, in step with the clock
+    SOFT_TIMER_DOMAIN_COUNT
+} Soft_Timer_Domain;
+
+typedef void (*Soft_Timer_Callback)(void* context);
+
+// Doubly linked list node used by the wheel slots
+typedef struct Soft_Timer_Link {
+    struct Soft_Timer_Link* next;
+    struct Soft_Timer_Link* prev;
+} Soft_Timer_Link;
+
+/**
+ * @brief A software timer. The wheel links the timer itself, so no memory is allocated.
+ *
+ * Set it up once with Soft_Timer_Setup; the fields are private to Soft_Timer.c.
+ */
+typedef struct {
+    Soft_Timer_Link link;           // Must stay the first member
+    uint32_t expiry;                // Absolute tick of the domain
+    uint32_t period;                // Reload in ticks, 0 for a one-shot timer
+    Soft_Timer_Callback callback;   // NULL to deliver through the fired flag
+    void* context;
+    uint8_t domain;
+    uint8_t active;
+    volatile uint8_t fired;
+} Soft_Timer;
+
+/**
+ * @brief Initializes the timer wheels and configures the 1 kHz Timer2A tick.
+ *
+ * Must be called before any timer is started and before the clock is started.
+ */
+void Soft_Timer_Init(void);
+
+/**
+ * @brief Prepares a timer for use. The timer is left stopped.
+ *
+ * @param timer    The timer to set up.
+ * @param domain   Tick source of the timer.
+ * @param callback Function called from Soft_Timer_Service when the timer expires, or NULL.
+ * @param context  Argument passed to the callback.
+ */
+void Soft_Timer_Setup(Soft_Timer* timer, Soft_Timer_Domain domain,
+                      Soft_Timer_Callback callback, void* context);
+
+/**
+ * @brief Starts or restarts a timer.
+ *
+ * @param timer  The timer to start.
+ * @param ticks  Ticks until the first expiry (0 expires on the next tick).
+ * @param period Ticks between later expiries, or 0 for a one-shot timer.
+ */
+void Soft_Timer_Start(Soft_Timer* timer, uint32_t ticks, uint32_t period);
+
+/**
+ * @brief Stops a timer. Does nothing if the timer is not running.
+ *
+ * A pending fired flag is cleared as well.
+ */
+void Soft_Timer_Cancel(Soft_Timer* timer);
+
+/**
+ * @brief Returns 1 if the timer is running, 0 otherwise.
+ */
+uint8_t Soft_Timer_Is_Active(const Soft_Timer* timer);
+
+/**
+ * @brief Returns 1 and clears the flag if the timer expired since the last call.
+ *
+ * Used by timers set up without a callback.
+ */
+uint8_t Soft_Timer_Take_Fired(Soft_Timer* timer);
+
+/**
+ * @brief Counts one tick of a domain. Called from the tick interrupts.
+ *
+ * @param domain The domain that ticked.
+ */
+void Soft_Timer_Tick(Soft_Timer_Domain domain);
+
+/**
+ * @brief Advances the wheels to the current tick and delivers the expired timers.
+ *
+ * Call it from the main loop on every pass. Every tick counted since the last
+ * call is processed in order, so no expiry is skipped.
+ */
+void Soft_Timer_Service(void);
+
+/**
+ * @brief Returns 1 if a tick has been counted that Soft_Timer_Service has not processed yet.
+ *
+ * Used by the idle loop to decide whether it may sleep.
+ */
+uint8_t Soft_Timer_Has_Pending_Ticks(void);
+
+/**
+ * @brief Returns the number of running timers.
+ */
+uint32_t Soft_Timer_Get_Active_Count(void);
+
+/**
+ * @brief Returns the number of expiries delivered after their tick had already passed.
+ */
+uint32_t Soft_Timer_Get_Late_Count(void);
+
+#endif
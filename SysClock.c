@@ -0,0 +1,49 @@
+/**
+ * @file SysClock.c
+ * @brief PLL configuration that runs the system clock at F_CPU.
+ *
+ * Follows the PLL initialization sequence of Section 5.3 (Initialization
+ * and Configuration) of the TM4C123GH6PM datasheet using the RCC2 register.
+ */
+
+#include "SysClock.h"
+#include "TM4C123GH6PM.h"
+
+// RCC and RCC2 fields
+#define RCC_MOSCDIS         (1UL << 0)
+#define RCC_XTAL_M          (0x1FUL << 6)
+#define RCC_XTAL_16MHZ      (0x15UL << 6)
+#define RCC2_OSCSRC2_M      (0x07UL << 4)
+#define RCC2_OSCSRC2_MOSC   (0x00UL << 4)
+#define RCC2_BYPASS2        (1UL << 11)
+#define RCC2_PWRDN2         (1UL << 13)
+#define RCC2_SYSDIV2_M      (0x7FUL << 22)      // SYSDIV2 and SYSDIV2LSB
+#define RCC2_DIV400         (1UL << 30)
+#define RCC2_USERCC2        (1UL << 31)
+
+// PLL Lock Raw Interrupt Status in the RIS register
+#define RIS_PLLLRIS         (1UL << 6)
+
+void SysClock_Init(void)
+{
+    // Use RCC2 for its wider divider and run from the oscillator while the PLL is set up
+    SYSCTL->RCC2 |= RCC2_USERCC2;
+    SYSCTL->RCC2 |= RCC2_BYPASS2;
+
+    // Enable the 16 MHz main oscillator and select it as the PLL input
+    SYSCTL->RCC = (SYSCTL->RCC & ~(RCC_XTAL_M | RCC_MOSCDIS)) | RCC_XTAL_16MHZ;
+    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~RCC2_OSCSRC2_M) | RCC2_OSCSRC2_MOSC;
+
+    // Power up the PLL
+    SYSCTL->RCC2 &= ~RCC2_PWRDN2;
+
+    // Divide the 400 MHz PLL output down to F_CPU
+    SYSCTL->RCC2 |= RCC2_DIV400;
+    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~RCC2_SYSDIV2_M) | ((SYSCLOCK_PLL_DIVISOR - 1) << 22);
+
+    // Wait for the PLL to lock, then switch the system clock over to it
+    while ((SYSCTL->RIS & RIS_PLLLRIS) == 0);
+    SYSCTL->RCC2 &= ~RCC2_BYPASS2;
+
+    SystemCoreClock = F_CPU;
+}
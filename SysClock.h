@@ -0,0 +1,49 @@
+/**
+ * @file SysClock.h
+ *
+ * @brief Interface for the system clock configuration.
+ *
+ * F_CPU is the single source of the system clock frequency. SysClock_Init
+ * runs the PLL from the 16 MHz main oscillator and divides its 400 MHz
+ * output down to F_CPU, and every timer reload and delay in the project
+ * is derived from F_CPU at compile time.
+ *
+ * F_CPU must divide 400 MHz by 5 to 128, e.g. 80, 50, 40, 20 or 16 MHz.
+ * Override it in the project's preprocessor symbols.
+ *
+ * The ADC clock comes from the PLL (400 MHz / 25 = 16 MHz) and does not
+ * depend on F_CPU, but it requires the PLL to be running.
+ */
+#ifndef SYSCLOCK_H
+#define SYSCLOCK_H
+
+#include <stdint.h>
+
+// System clock frequency in Hz
+#ifndef F_CPU
+#define F_CPU 80000000UL
+#endif
+
+// PLL output used by the system clock divider (DIV400 mode)
+#define SYSCLOCK_PLL_HZ 400000000UL
+
+// Divisor applied to the PLL output, written to SYSDIV2:SYSDIV2LSB as (divisor - 1)
+#define SYSCLOCK_PLL_DIVISOR (SYSCLOCK_PLL_HZ / F_CPU)
+
+// System clock cycles per microsecond
+#define SYSCLOCK_CYCLES_PER_US (F_CPU / 1000000UL)
+
+_Static_assert((SYSCLOCK_PLL_HZ % F_CPU) == 0, "F_CPU must divide the 400 MHz PLL output");
+_Static_assert((SYSCLOCK_PLL_DIVISOR >= 5) && (SYSCLOCK_PLL_DIVISOR <= 128),
+               "F_CPU must be between 3.125 MHz and 80 MHz");
+_Static_assert((F_CPU % 1000000UL) == 0, "F_CPU must be a whole number of MHz");
+
+/**
+ * @brief Runs the system clock at F_CPU from the PLL.
+ *
+ * Must be called first in main, before any peripheral is configured.
+ * Also updates SystemCoreClock.
+ */
+void SysClock_Init(void);
+
+#endif
@@ -1,29 +1,136 @@
-#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+#include "Power.h"
+#include "Profile.h"
+
+// Timer5A counts down over its full 32-bit range; each wrap adds 2^32 cycles.
+// The 24-bit SysTick would wrap, and wake the idle loop, every 210 ms
+#define SYSTICK_RELOAD      0xFFFFFFFFUL
+#define SYSTICK_WRAP_SHIFT  32
+
+// Number of counter wraps since initialization (upper bits of the timebase)
+static volatile uint32_t systick_wraps = 0;
 
 void SysTick_Delay_Init(void)
 {
-    SysTick->CTRL = 0;          // Disable SysTick
-    SysTick->LOAD = 0x00FFFFFF;
-    SysTick->VAL = 0;
-    SysTick->CTRL = 0x05;       // Enable SysTick with system clock
+    SysTick->CTRL = 0;              // SysTick is not used
+
+    // Enable Timer5 clock
+    SYSCTL->RCGCTIMER |= 0x20;
+    while ((SYSCTL->PRTIMER & 0x20) == 0);
+
+    // 32-bit periodic count-down timer from the system clock
+    TIMER5->CTL = 0x00;
+    TIMER5->CFG = 0x00;
+    TIMER5->TAMR = 0x02;
+    TIMER5->TAILR = SYSTICK_RELOAD;
+    systick_wraps = 0;
+
+    // Wrap interrupt
+    TIMER5->ICR = 0x01;
+    TIMER5->IMR = 0x01;
+    NVIC_EnableIRQ(TIMER5A_IRQn);
+
+    TIMER5->CTL = 0x01;
+}
+
+void TIMER5A_Handler(void)
+{
+    PROFILE_BEGIN(PROFILE_TIMEBASE_ISR);
+    TIMER5->ICR = 0x01;
+    systick_wraps++;
+    PROFILE_END(PROFILE_TIMEBASE_ISR);
+}
+
+uint64_t SysTick_Now_Cycles(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t wraps = systick_wraps;
+    uint32_t value = TIMER5->TAV;
+
+    // A wrap that happened after interrupts were masked has not been counted yet.
+    // Read the counter again since the first read may be from before the wrap
+    if (TIMER5->RIS & 0x01)
+    {
+        value = TIMER5->TAV;
+        wraps++;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ((uint64_t)wraps << SYSTICK_WRAP_SHIFT) + (SYSTICK_RELOAD - value);
+}
+
+uint64_t SysTick_Now_us(void)
+{
+    return SysTick_Now_Cycles() / SYSTICK_CYCLES_PER_US;
+}
+
+uint64_t SysTick_Elapsed_Cycles(uint64_t start_cycles)
+{
+    return SysTick_Now_Cycles() - start_cycles;
 }
 
-void SysTick_Delay1ms(uint32_t ms)
+void SysTick_Deadline_Set_us(SysTick_Deadline* deadline, uint32_t delay_in_us)
 {
-    while (ms--)
+    deadline->expiry_cycles = SysTick_Now_Cycles() + ((uint64_t)delay_in_us * SYSTICK_CYCLES_PER_US);
+}
+
+void SysTick_Deadline_Set_ms(SysTick_Deadline* deadline, uint32_t delay_in_ms)
+{
+    deadline->expiry_cycles = SysTick_Now_Cycles() + ((uint64_t)delay_in_ms * 1000 * SYSTICK_CYCLES_PER_US);
+}
+
+uint8_t SysTick_Deadline_Expired(const SysTick_Deadline* deadline)
+{
+    return (SysTick_Now_Cycles() >= deadline->expiry_cycles);
+}
+
+uint32_t SysTick_Deadline_Remaining_us(const SysTick_Deadline* deadline)
+{
+    uint64_t now = SysTick_Now_Cycles();
+
+    if (now >= deadline->expiry_cycles)
+    {
+        return 0;
+    }
+    return (uint32_t)((deadline->expiry_cycles - now + SYSTICK_CYCLES_PER_US - 1) / SYSTICK_CYCLES_PER_US);
+}
+
+void SysTick_Delay_Cycles(uint32_t delay_in_cycles)
+{
+    uint64_t start = SysTick_Now_Cycles();
+    while (SysTick_Elapsed_Cycles(start) < delay_in_cycles);
+}
+
+void SysTick_Delay1us(uint32_t delay_in_us)
+{
+    SysTick_Deadline deadline;
+    SysTick_Deadline_Set_us(&deadline, delay_in_us);
+
+    if (delay_in_us >= POWER_SLEEP_MIN_US)
+    {
+        Power_Sleep_Until(&deadline);
+    }
+    else
     {
-        SysTick->LOAD = 16000 - 1; // 1 ms @ 16 MHz
-        SysTick->VAL = 0;
-        while ((SysTick->CTRL & 0x10000) == 0);
+        while (!SysTick_Deadline_Expired(&deadline));
     }
 }
 
-void SysTick_Delay1us(uint32_t us)
+void SysTick_Delay1ms(uint32_t delay_in_ms)
 {
-    while (us--)
+    SysTick_Deadline deadline;
+    SysTick_Deadline_Set_ms(&deadline, delay_in_ms);
+
+    // Long delays sleep between interrupts instead of spinning
+    if (delay_in_ms >= (POWER_SLEEP_MIN_US / 1000))
+    {
+        Power_Sleep_Until(&deadline);
+    }
+    else
     {
-        SysTick->LOAD = 16 - 1;  // 1 us @ 16 MHz
-        SysTick->VAL = 0;
-        while ((SysTick->CTRL & 0x10000) == 0);
+        while (!SysTick_Deadline_Expired(&deadline));
     }
 }
@@ -3,26 +3,47 @@
  *
  * @brief Header file for the SysTick_Delay driver.
  *
- * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
- * 
- * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
- * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
- * The timer is used for creating delays in either microseconds or milliseconds.
+ * Timer5A runs freely from the system clock over its full 32-bit range. Its wrap
+ * interrupt extends the count to a monotonic 64-bit cycle counter, so any module
+ * can ask for the current time, measure elapsed time or poll a deadline instead of
+ * spinning. The blocking delay functions are built on top of it; delays of at
+ * least POWER_SLEEP_MIN_US sleep between interrupts (see Power.h).
+ *
+ * The counter wraps every 2^32 cycles (about 54 s at 80 MHz), so it rarely wakes
+ * the idle loop. The 24-bit SysTick timer it replaces wrapped every 210 ms. Reads
+ * stay correct with interrupts masked for up to one wrap period. The functions
+ * keep their SysTick names.
  *
  * @author Aaron Nanas
  */
- 
+#ifndef SYSTICK_DELAY_H
+#define SYSTICK_DELAY_H
+
 #include "TM4C123GH6PM.h"
+#include "SysClock.h"
+
+// The timebase runs from the system clock
+#define SYSTICK_CLOCK_HZ        F_CPU
+#define SYSTICK_CYCLES_PER_US   SYSCLOCK_CYCLES_PER_US
+
+// Converts nanoseconds to SysTick cycles, rounded up
+#define SYSTICK_CYCLES_FROM_NS(ns) ((((uint32_t)(ns) * SYSTICK_CYCLES_PER_US) + 999UL) / 1000UL)
+
+/**
+ * @brief A point in time on the 64-bit SysTick timebase.
+ *
+ * Set it with SysTick_Deadline_Set_us or SysTick_Deadline_Set_ms and poll it with SysTick_Deadline_Expired.
+ */
+typedef struct
+{
+    uint64_t expiry_cycles;
+} SysTick_Deadline;
 
 /**
- * @brief The SysTick_Delay_Init function initializes the SysTick timer to be used for a blocking delay function.
+ * @brief The SysTick_Delay_Init function starts the free-running timebase.
  *
- * This function configures the SysTick timer and its interrupt with a specified reload value to 
- * generate interrupts every 1 us. It uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
- * The PIOSC provides 16 MHz which is then divided by 4. The timer is used for creating delays in either 
- * microseconds or milliseconds.
+ * This function configures Timer5A to count down from 0xFFFFFFFF using the system clock
+ * and enables its wrap interrupt. The timebase starts at zero.
  *
  * @param None
  *
@@ -31,10 +52,93 @@
 void SysTick_Delay_Init(void);
 
 /**
- * @brief The SysTick_Delay1us function provides a blocking delay in microseconds using the SysTick timer.
+ * @brief Returns the number of system clock cycles since SysTick_Delay_Init was called.
+ *
+ * It can be called from interrupt handlers and with interrupts masked.
+ *
+ * @param None
+ *
+ * @return The 64-bit cycle count.
+ */
+uint64_t SysTick_Now_Cycles(void);
+
+/**
+ * @brief Returns the number of microseconds since SysTick_Delay_Init was called.
  *
- * This function resets the global variable, us_elapsed, to zero and waits until us_elapsed reaches 
- * the specified delay_in_us.
+ * @param None
+ *
+ * @return The 64-bit microsecond count.
+ */
+uint64_t SysTick_Now_us(void);
+
+/**
+ * @brief Returns the number of cycles elapsed since a previous SysTick_Now_Cycles reading.
+ *
+ * @param start_cycles The earlier reading.
+ *
+ * @return The elapsed cycles.
+ */
+uint64_t SysTick_Elapsed_Cycles(uint64_t start_cycles);
+
+/**
+ * @brief Sets a deadline a number of microseconds from now.
+ *
+ * @param deadline The deadline to set.
+ *
+ * @param delay_in_us The time until the deadline expires, in microseconds.
+ *
+ * @return None
+ */
+void SysTick_Deadline_Set_us(SysTick_Deadline* deadline, uint32_t delay_in_us);
+
+/**
+ * @brief Sets a deadline a number of milliseconds from now.
+ *
+ * @param deadline The deadline to set.
+ *
+ * @param delay_in_ms The time until the deadline expires, in milliseconds.
+ *
+ * @return None
+ */
+void SysTick_Deadline_Set_ms(SysTick_Deadline* deadline, uint32_t delay_in_ms);
+
+/**
+ * @brief Returns 1 if the deadline has passed, 0 otherwise. It never blocks.
+ *
+ * A zero-initialized deadline has always expired.
+ *
+ * @param deadline The deadline to check.
+ *
+ * @return 1 if expired, 0 otherwise.
+ */
+uint8_t SysTick_Deadline_Expired(const SysTick_Deadline* deadline);
+
+/**
+ * @brief Returns the number of microseconds until the deadline expires, or 0 if it has expired.
+ *
+ * @param deadline The deadline to check.
+ *
+ * @return The remaining time in microseconds.
+ */
+uint32_t SysTick_Deadline_Remaining_us(const SysTick_Deadline* deadline);
+
+/**
+ * @brief The SysTick_Delay_Cycles function provides a blocking delay in system clock cycles.
+ *
+ * This function is meant for sub-microsecond delays (see SYSTICK_CYCLES_FROM_NS).
+ * The delay lasts at least the requested number of cycles plus the cost of one timebase read.
+ *
+ * @param delay_in_cycles The delay time in system clock cycles.
+ *
+ * @return None
+ */
+void SysTick_Delay_Cycles(uint32_t delay_in_cycles);
+
+/**
+ * @brief The SysTick_Delay1us function provides a blocking delay in microseconds using the Timer5A timebase.
+ *
+ * This function waits until the timebase has advanced by the specified number of microseconds.
+ * Delays of at least POWER_SLEEP_MIN_US sleep with Power_Sleep_Until; shorter ones spin.
  *
  * @param delay_in_us The delay time in microseconds.
  *
@@ -43,11 +147,10 @@ void SysTick_Delay_Init(void);
 void SysTick_Delay1us(uint32_t delay_in_us);
 
 /**
- * @brief The SysTick_Delay1ms function provides a blocking delay in milliseconds using the SysTick timer.
+ * @brief The SysTick_Delay1ms function provides a blocking delay in milliseconds using the Timer5A timebase.
  *
- * This function clears the global variables, us_elapsed and ms_elapsed, to zero and sets ms_active flag to 0x01 
- * indicating that milliseconds delay is active. It then waits until ms_elapsed reaches the specified delay_in_ms.
- * After the delay, it clears ms_active flag back to 0x00.
+ * This function waits until the timebase has advanced by the specified number of milliseconds.
+ * Delays of at least POWER_SLEEP_MIN_US sleep with Power_Sleep_Until; shorter ones spin.
  *
  * @param delay_in_ms The delay time in milliseconds.
  *
@@ -56,14 +159,15 @@ void SysTick_Delay1us(uint32_t delay_in_us);
 void SysTick_Delay1ms(uint32_t delay_in_ms);
 
 /**
- * @brief The SysTick_Handler function is the interrupt service routine for the SysTick timer.
+ * @brief The TIMER5A_Handler function is the interrupt service routine for the Timer5A timebase.
  *
- * This function is called whenever the SysTick timer generates an interrupt. It increments the global variable
- * us_elapsed by 1, indicating that 1 microsecond has passed. Additionally, if us_elapsed reaches 1000 and ms_active
- * flag is set to 0x01, it resets us_elapsed and increments ms_elapsed by 1, indicating that 1 millisecond has passed.
+ * This function is called every time the 32-bit Timer5A counter wraps from zero to 0xFFFFFFFF.
+ * It increments the upper bits of the 64-bit timebase.
  *
  * @param None
  *
  * @return None
  */
-void SysTick_Handler(void);
+void TIMER5A_Handler(void);
+
+#endif
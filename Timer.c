@@ -1,10 +1,49 @@
 /**
  * @file Timer.c
- * @brief Timer0A configuration for 1 Hz time interrupt.
+ * @brief Timer0A configuration for 1 Hz time interrupt with a fractional trim,
+ *        Timer2A configuration for the 1 kHz software timer tick,
+ *        Timer3A configuration for the ADC trigger and
+ *        Timer4A configuration for the 1 kHz button sampling tick.
  */
 
 #include "TM4C123GH6PM.h"
 #include "Clock.h"
+#include "Soft_Timer.h"
+#include "SysClock.h"
+#include "Profile.h"
+#include "Buttons.h"
+
+_Static_assert((F_CPU % SOFT_TIMER_FAST_TICK_HZ) == 0, "F_CPU must be a multiple of the fast tick rate");
+
+// The trim adds SYSCLOCK_CYCLES_PER_US * trim_ppb / 1000 cycles to each 1 s period.
+// The whole cycles go into the reload; the thousandths are accumulated and add
+// one cycle to the periods where they overflow, so the average period is exact
+#define TIMER0A_TRIM_DENOMINATOR 1000
+
+static int32_t trim_cycles = 0;             // Whole cycles added to every period
+static uint32_t trim_fraction = 0;          // Thousandths of a cycle added to every period
+static uint32_t trim_accumulator = 0;
+
+void Timer0A_Set_Trim_ppb(int32_t trim_ppb)
+{
+    int64_t extra = (int64_t)SYSCLOCK_CYCLES_PER_US * trim_ppb;
+
+    // Round toward minus infinity so the fraction is never negative
+    int32_t cycles = (int32_t)(extra / TIMER0A_TRIM_DENOMINATOR);
+    if ((extra % TIMER0A_TRIM_DENOMINATOR) < 0)
+    {
+        cycles--;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    trim_cycles = cycles;
+    trim_fraction = (uint32_t)(extra - (int64_t)cycles * TIMER0A_TRIM_DENOMINATOR);
+    trim_accumulator = 0;
+
+    __set_PRIMASK(primask);
+}
 
 void Timer0A_Init_1Hz(void)
 {
@@ -17,11 +56,12 @@ void Timer0A_Init_1Hz(void)
     // Configure for 32-bit timer mode
     TIMER0->CFG = 0x00;
 
-    // Configure Timer0A for periodic mode
-    TIMER0->TAMR = 0x02;
+    // Configure Timer0A for periodic mode. A new reload takes effect at the
+    // next timeout (TAILD), so the trim never cuts a period short
+    TIMER0->TAMR = 0x02 | 0x100;
 
-    // Set reload value for 1Hz (50 MHz clock assumed)
-    TIMER0->TAILR = 50000000 - 1;
+    // Set reload value for 1Hz
+    TIMER0->TAILR = F_CPU - 1;
 
     // Clear timeout flag
     TIMER0->ICR = 0x01;
@@ -38,6 +78,161 @@ void Timer0A_Init_1Hz(void)
 
 void TIMER0A_Handler(void)
 {
+    PROFILE_BEGIN(PROFILE_TIMER0A_ISR);
     TIMER0->ICR = 0x01;  // Clear interrupt flag
+
+    // Reload for the period after the one that just started
+    uint32_t reload = (uint32_t)((int32_t)(F_CPU - 1) + trim_cycles);
+    trim_accumulator += trim_fraction;
+    if (trim_accumulator >= TIMER0A_TRIM_DENOMINATOR)
+    {
+        trim_accumulator -= TIMER0A_TRIM_DENOMINATOR;
+        reload++;
+    }
+    TIMER0->TAILR = reload;
+
+    Soft_Timer_Tick(SOFT_TIMER_DOMAIN_SECONDS);
     Clock_Tick();        // Advance time and trigger update
+    PROFILE_END(PROFILE_TIMER0A_ISR);
+}
+
+void Timer2A_Init_1kHz(void)
+{
+    // Enable Timer2 clock
+    SYSCTL->RCGCTIMER |= 0x04;
+
+    // Disable Timer2A before configuration
+    TIMER2->CTL = 0x00;
+
+    // Configure for 32-bit timer mode
+    TIMER2->CFG = 0x00;
+
+    // Configure Timer2A for periodic mode
+    TIMER2->TAMR = 0x02;
+
+    // Set reload value for 1 kHz
+    TIMER2->TAILR = (F_CPU / SOFT_TIMER_FAST_TICK_HZ) - 1;
+
+    // Clear timeout flag
+    TIMER2->ICR = 0x01;
+
+    // Enable Timer2A timeout interrupt
+    TIMER2->IMR = 0x01;
+
+    // Enable Timer2A interrupt in NVIC
+    NVIC_EnableIRQ(TIMER2A_IRQn);
+
+    // Timer2A is left stopped until a software timer needs it
+}
+
+void Timer2A_Start(void)
+{
+    // Start a full period so the first tick is not early
+    TIMER2->TAV = TIMER2->TAILR;
+    TIMER2->CTL |= 0x01;
+}
+
+void Timer2A_Stop(void)
+{
+    TIMER2->CTL &= ~0x01;
+}
+
+void TIMER2A_Handler(void)
+{
+    PROFILE_BEGIN(PROFILE_TIMER2A_ISR);
+    TIMER2->ICR = 0x01;  // Clear interrupt flag
+    Soft_Timer_Tick(SOFT_TIMER_DOMAIN_FAST);
+    PROFILE_END(PROFILE_TIMER2A_ISR);
+}
+
+void Timer3A_Init_ADC_Trigger(uint32_t rate_hz)
+{
+    // Enable Timer3 clock
+    SYSCTL->RCGCTIMER |= 0x08;
+
+    // Disable Timer3A before configuration
+    TIMER3->CTL = 0x00;
+
+    // Configure for 32-bit timer mode
+    TIMER3->CFG = 0x00;
+
+    // Configure Timer3A for periodic mode
+    TIMER3->TAMR = 0x02;
+
+    // Set reload value for the sampling rate
+    TIMER3->TAILR = (F_CPU / rate_hz) - 1;
+
+    // No interrupt: each timeout triggers the ADC instead (TAOTE)
+    TIMER3->IMR = 0x00;
+    TIMER3->CTL = 0x20;
+
+    // Timer3A is left stopped until the ADC is started
+}
+
+void Timer3A_Set_Rate(uint32_t rate_hz)
+{
+    TIMER3->TAILR = (F_CPU / rate_hz) - 1;
+}
+
+void Timer3A_Start(void)
+{
+    TIMER3->TAV = TIMER3->TAILR;
+    TIMER3->CTL |= 0x01;
+}
+
+void Timer3A_Stop(void)
+{
+    TIMER3->CTL &= ~0x01;
+}
+
+void Timer4A_Init_1kHz(void)
+{
+    // Enable Timer4 clock
+    SYSCTL->RCGCTIMER |= 0x10;
+
+    // Disable Timer4A before configuration
+    TIMER4->CTL = 0x00;
+
+    // Configure for 32-bit timer mode
+    TIMER4->CFG = 0x00;
+
+    // Configure Timer4A for periodic mode
+    TIMER4->TAMR = 0x02;
+
+    // Set reload value for 1 kHz
+    TIMER4->TAILR = (F_CPU / BUTTONS_SAMPLE_HZ) - 1;
+
+    // Clear timeout flag
+    TIMER4->ICR = 0x01;
+
+    // Enable Timer4A timeout interrupt
+    TIMER4->IMR = 0x01;
+
+    // Enable Timer4A interrupt in NVIC
+    NVIC_EnableIRQ(TIMER4A_IRQn);
+
+    // Timer4A is left stopped until a button edge starts it
+}
+
+void Timer4A_Start(void)
+{
+    // A running timer keeps its phase
+    if (!(TIMER4->CTL & 0x01))
+    {
+        TIMER4->TAV = TIMER4->TAILR;
+        TIMER4->CTL |= 0x01;
+    }
+}
+
+void Timer4A_Stop(void)
+{
+    TIMER4->CTL &= ~0x01;
+}
+
+void TIMER4A_Handler(void)
+{
+    PROFILE_BEGIN(PROFILE_TIMER4A_ISR);
+    TIMER4->ICR = 0x01;  // Clear interrupt flag
+    Buttons_Sample();
+    PROFILE_END(PROFILE_TIMER4A_ISR);
 }
@@ -4,16 +4,27 @@
  * @brief Interface for configuring Timer0A to generate a 1 Hz interrupt.
  *
  * This module sets up Timer0A in 32-bit periodic mode to trigger
- * once per second using a 50 MHz system clock. It is used to drive
+ * once per second. Reload values are derived from F_CPU (see SysClock.h). It is used to drive
  * time updates for the digital clock.
+ *
+ * Timer2A triggers every millisecond and drives the fast domain of
+ * the software timers (see Soft_Timer.h). It only runs while a fast
+ * software timer is active, so an idle system is not woken every 1 ms.
+ *
+ * Timer3A triggers the ADC conversions (see ADC.h) without an interrupt.
+ *
+ * Timer4A samples the buttons every millisecond (see Buttons.h) while
+ * one of them is bouncing or held.
  */
 
+#include <stdint.h>
+
 
 /**
  * @brief Initializes Timer0A to trigger an interrupt every 1 second.
  *
- * - Assumes a 50 MHz system clock.
- * - Configures Timer0A in 32-bit periodic mode.
+ * - Reload value derived from F_CPU.
+ * - Configures Timer0A in 32-bit periodic mode; the reload is updated from the ISR to apply the trim.
  * - Enables the timer and its interrupt in the NVIC.
  * - The Timer0A ISR (`TIMER0A_Handler`) should call `Clock_Tick()`.
  */
@@ -26,3 +37,97 @@ void Timer0A_Init_1Hz(void);
  * to update the clock every second.
  */
 void Timer0A_Handler(void);
+
+/**
+ * @brief Trims the 1 s period of Timer0A.
+ *
+ * A positive trim lengthens the period to make up for a fast oscillator.
+ * The reload changes by whole cycles from one period to the next so the
+ * average period is F_CPU * (1 + trim_ppb / 10^9) cycles.
+ *
+ * @param trim_ppb Oscillator error in parts per billion (1000 = 1 ppm).
+ */
+void Timer0A_Set_Trim_ppb(int32_t trim_ppb);
+
+/**
+ * @brief Initializes Timer2A to trigger an interrupt every 1 ms.
+ *
+ * - Reload value derived from F_CPU.
+ * - Configures Timer2A in 32-bit periodic mode.
+ * - Enables its interrupt in the NVIC but leaves the timer stopped.
+ * - Called by Soft_Timer_Init.
+ */
+void Timer2A_Init_1kHz(void);
+
+/**
+ * @brief Starts Timer2A with a full 1 ms period.
+ */
+void Timer2A_Start(void);
+
+/**
+ * @brief Stops Timer2A.
+ */
+void Timer2A_Stop(void);
+
+/**
+ * @brief Timer2A interrupt handler.
+ *
+ * Clears the interrupt flag and counts one tick of the
+ * software timers' fast domain.
+ */
+void TIMER2A_Handler(void);
+
+/**
+ * @brief Initializes Timer3A to trigger ADC conversions.
+ *
+ * - Configures Timer3A in 32-bit periodic mode with the ADC trigger output (TAOTE).
+ * - No interrupt is used; the timer is left stopped.
+ * - Called by ADC_Init.
+ *
+ * @param rate_hz Triggers per second.
+ */
+void Timer3A_Init_ADC_Trigger(uint32_t rate_hz);
+
+/**
+ * @brief Changes the Timer3A trigger rate.
+ *
+ * @param rate_hz Triggers per second.
+ */
+void Timer3A_Set_Rate(uint32_t rate_hz);
+
+/**
+ * @brief Starts Timer3A with a full period.
+ */
+void Timer3A_Start(void);
+
+/**
+ * @brief Stops Timer3A.
+ */
+void Timer3A_Stop(void);
+
+/**
+ * @brief Initializes Timer4A to trigger an interrupt every 1 ms.
+ *
+ * - Reload value derived from F_CPU and BUTTONS_SAMPLE_HZ.
+ * - Configures Timer4A in 32-bit periodic mode.
+ * - Enables its interrupt in the NVIC but leaves the timer stopped.
+ * - Called by Buttons_Init.
+ */
+void Timer4A_Init_1kHz(void);
+
+/**
+ * @brief Starts Timer4A with a full period. Does nothing if it is already running.
+ */
+void Timer4A_Start(void);
+
+/**
+ * @brief Stops Timer4A.
+ */
+void Timer4A_Stop(void);
+
+/**
+ * @brief Timer4A interrupt handler.
+ *
+ * Clears the interrupt flag and samples the buttons.
+ */
+void TIMER4A_Handler(void);
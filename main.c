@@ -9,10 +9,13 @@
  * through buttons SW2SW5 on the EduBase board.
  *
  * Features:
- *  - Manual time set mode on startup using buttons
- *  - Alarm set and enable/disable control
+ *  - Manual time set mode on startup using buttons or the potentiometer
+ *    dial, skipped when the time kept by the Hibernation RTC survived the reset
+ *  - Alarm set and enable/disable control; turning the dial sets the alarm
+ *  - Drift calibration mode (SW5) that trims the clock's time base
+ *  - Holding SW5 switches between the text and big-digit clock faces
  *  - Alarm triggers LEDs and snooze cycle
- *  - Light sensor (PE1) used to turn off the alarm
+ *  - Light sensor (PE1) or SW4 used to turn off the alarm
  *  - LCD display shows current time and status
  *
  * Pin Assignments:
@@ -23,32 +26,45 @@
  *  - Alarm LED Indicator  : PF1 - first iteration
  *  - Buttons SW2SW5      : PD3 (SW2), PD2 (SW3), PD1 (SW4), PD0 (SW5)
  *  - Light Sensor Input   : PE1 (AIN2)
+ *  - Potentiometer Input  : PE2 (AIN1)
  *
  * Modules Used:
  *  - Clock        : Handles timekeeping and alarm time
+ *  - Hib_RTC      : Hibernation module RTC backend of the clock
  *  - Display      : Updates LCD with current time
- *  - Timer        : Generates 1 Hz interrupt using Timer0A
- *  - SysTick_Delay: Provides ms/us blocking delays
+ *  - SysClock     : Runs the system clock at F_CPU through the PLL
+ *  - Timer        : 1 Hz Timer0A clock backend and the 1 kHz soft timer tick
+ *  - Soft_Timer   : Software timers for the snooze cycle and messages
+ *  - SysTick_Delay: 64-bit timebase, deadlines and ms/us delays
  *  - Alarm        : Controls buzzer and alarm LED
  *  - GPIO         : Initializes LEDs and buttons
- *  - Buttons      : Interrupt-driven input from SW2SW5
- *  - ADC          : Samples light sensor on PE1 to cancel alarm
+ *  - Buttons      : Timer-sampled, debounced input from SW2SW5
+ *  - ADC          : Timer-triggered sampling of the potentiometer and the light sensor
+ *  - Light_Sensor : Filtered light sensor dismiss of the alarm
+ *  - Dial         : Potentiometer as a dial for the hour and minute
+ *  - Profile      : DWT cycle-count probes (PROFILE_ENABLED builds only)
  *
  * Author: [Mario Hernandez]
  */
 #include "Clock.h"
 #include "Display.h"
-#include "Timer.h"
 #include "SysTick_Delay.h"
 #include "Alarm.h"
 #include "GPIO.h"
 #include "EduBase_LCD.h"
 #include "Buttons.h"
 #include "ADC.h"
-#include <stdio.h>
+#include "Light_Sensor.h"
+#include "Dial.h"
+#include "Format.h"
+#include "Soft_Timer.h"
+#include "SysClock.h"
+#include "Power.h"
+#include "Profile.h"
+#include <string.h>
 
-// Tracks time until message clears and clock resumes
-static int lcd_message_timer = 0;
+// Seconds a status message stays on screen before the clock resumes
+#define MESSAGE_SECONDS 3
 
 // Time set flag
 int time_set_mode = 1;
@@ -58,14 +74,36 @@ int temp_hour = 0;
 int temp_minute = 0;
 int temp_second = 0; // Not used
 
-// Light sensor buffer
-static double adc_buffer[8];
+// Field of an hour and minute being set with the dial; SW4 moves on to the next
+typedef enum {
+    SET_FIELD_NONE,
+    SET_FIELD_HOUR,
+    SET_FIELD_MINUTE
+} Set_Field;
+
+static Set_Field time_set_field = SET_FIELD_HOUR;
+static uint8_t time_set_redraw = 1;
+
+// Turning the dial in normal mode sets the alarm; it is left unchanged
+// when no field is confirmed for ALARM_DIAL_TIMEOUT_SECONDS
+#define ALARM_DIAL_TIMEOUT_SECONDS 10
+static Set_Field alarm_dial_field = SET_FIELD_NONE;
+static int dial_alarm_hour = 0;
+static int dial_alarm_minute = 0;
+static Soft_Timer alarm_dial_timer;
+
+// Set while a held SW5 has switched the face, so its release is not a short press
+static uint8_t face_switched = 0;
+
 int alarm_triggered_flag = 0;
 
-// Snooze logic
-int snooze_mode = 0;
-int led_flash_timer = 0;
-int snooze_countdown = 5;
+// Snooze logic: the LEDs flash for SNOOZE_FLASH_SECONDS, then a countdown
+// from SNOOZE_COUNTDOWN_SECONDS runs before they flash again
+#define SNOOZE_FLASH_SECONDS     5
+#define SNOOZE_COUNTDOWN_SECONDS 5
+static Soft_Timer led_flash_timer;
+static Soft_Timer snooze_countdown_timer;
+int snooze_countdown = SNOOZE_COUNTDOWN_SECONDS;
 
 // External Clock.c variables
 extern volatile int update_display_flag;
@@ -73,54 +111,254 @@ extern int alarm_hour;
 extern int alarm_minute;
 extern int alarm_second;
 
+// End of the LED flash: start the countdown
+static void Snooze_Flash_Done(void* context)
+{
+    (void)context;
+
+    EduBase_LEDs_Output(0x00); // Turn LEDs OFF
+    snooze_countdown = SNOOZE_COUNTDOWN_SECONDS;
+    Soft_Timer_Start(&snooze_countdown_timer, 1, 1);
+}
+
+// One second of the countdown: show it and flash the LEDs again at zero
+static void Snooze_Countdown_Step(void* context)
+{
+    (void)context;
+
+    snooze_countdown--;
+    char cd_buf[8];
+    const uint8_t cd_value = (uint8_t)snooze_countdown;
+    Format_Template_Apply(cd_buf, &FORMAT_COUNTDOWN, &cd_value);
+    Display_Region_Set(DISPLAY_REGION_COUNTDOWN, 0, cd_buf);
+
+    if (snooze_countdown <= 0)
+    {
+        Soft_Timer_Cancel(&snooze_countdown_timer);
+        EduBase_LEDs_Output(0x0F); // Flash LEDs
+        Soft_Timer_Start(&led_flash_timer, SNOOZE_FLASH_SECONDS, 0);
+    }
+}
+
+// Turns the ringing alarm off and ends the snooze cycle
+static void Alarm_Dismiss(void)
+{
+    Alarm_Off();
+    EduBase_LEDs_Output(0x00);
+    Display_Show_Message("Alarm", "Turned OFF", MESSAGE_SECONDS);
+
+    // Reset all alarm flags
+    alarm_triggered_flag = 0;
+    Soft_Timer_Cancel(&led_flash_timer);
+    Soft_Timer_Cancel(&snooze_countdown_timer);
+    Light_Sensor_Disarm();
+    snooze_countdown = SNOOZE_COUNTDOWN_SECONDS;
+
+    // Remove the countdown from the clock page
+    Display_Region_Hide(DISPLAY_REGION_COUNTDOWN);
+}
+
+#if PROFILE_ENABLED
+// Time each probe of a profile dump stays on the LCD
+#define PROFILE_DUMP_SCREEN_MS 2000
+
+static void Profile_LCD_Writer(const char* name, const char* line)
+{
+    Display_Show_Message(name, line, 0);
+    Display_Refresh();
+    SysTick_Delay1ms(PROFILE_DUMP_SCREEN_MS);
+}
+#endif
+
+// Minute step of each auto-repeat level of a held button
+static const uint8_t minute_steps[BUTTONS_REPEAT_LEVELS] = { 1, 5, 10 };
+
+// Moves value up to the next multiple of step, wrapping at modulo
+static int Step_Up(int value, int step, int modulo)
+{
+    return ((value / step + 1) * step) % modulo;
+}
+
+static void Show_Alarm_Time(void)
+{
+    char buf[17];
+    const uint8_t alarm_values[2] = { (uint8_t)alarm_hour, (uint8_t)alarm_minute };
+    Format_Template_Apply(buf, &FORMAT_ALARM_HHMM, alarm_values);
+    Display_Show_Message("Alarm Time", buf, MESSAGE_SECONDS);
+}
+
+// Points the dial at the field being set
+static void Dial_Start_Field(Set_Field field, int hour, int minute)
+{
+    if (field == SET_FIELD_HOUR)
+    {
+        Dial_Start(24, (uint8_t)hour);
+    }
+    else
+    {
+        Dial_Start(60, (uint8_t)minute);
+    }
+}
+
+static void Set_Field_Value(Set_Field field, int* hour, int* minute, uint8_t value)
+{
+    if (field == SET_FIELD_HOUR)
+    {
+        *hour = value;
+    }
+    else
+    {
+        *minute = value;
+    }
+}
+
+static void Show_Alarm_Dial(void)
+{
+    char buf[17];
+    const uint8_t alarm_values[2] = { (uint8_t)dial_alarm_hour, (uint8_t)dial_alarm_minute };
+    Format_Template_Apply(buf, &FORMAT_ALARM_HHMM, alarm_values);
+    Display_Show_Message((alarm_dial_field == SET_FIELD_HOUR) ? "Alarm: Hour" : "Alarm: Minute", buf, 0);
+}
+
+// A dialed alarm field changed: show it and give the user more time
+static void Alarm_Dial_Changed(void)
+{
+    Show_Alarm_Dial();
+    Soft_Timer_Start(&alarm_dial_timer, ALARM_DIAL_TIMEOUT_SECONDS, 0);
+}
+
+// No confirmation in time: keep the old alarm
+static void Alarm_Dial_Timeout(void* context)
+{
+    (void)context;
+
+    alarm_dial_field = SET_FIELD_NONE;
+    Dial_Watch();
+    Display_Hide_Message();
+}
+
+// Returns 1 if the main loop has something to do. Called with interrupts masked
+static uint8_t Main_Work_Pending(void)
+{
+    return update_display_flag || Soft_Timer_Has_Pending_Ticks() || Button_HasEvent() ||
+           Light_Sensor_Has_Work() ||
+           Dial_Has_Work();
+}
+
 int main(void)
 {
+    SysClock_Init();
+    Profile_Init();
     SysTick_Delay_Init();
     SysTick_Delay1ms(100);
 
+    Soft_Timer_Init();
+    Power_Init();
+    Soft_Timer_Setup(&led_flash_timer, SOFT_TIMER_DOMAIN_SECONDS, Snooze_Flash_Done, NULL);
+    Soft_Timer_Setup(&snooze_countdown_timer, SOFT_TIMER_DOMAIN_SECONDS, Snooze_Countdown_Step, NULL);
+    Soft_Timer_Setup(&alarm_dial_timer, SOFT_TIMER_DOMAIN_SECONDS, Alarm_Dial_Timeout, NULL);
+
     Display_Init();
     Clock_Init();
     Alarm_Init();
     Buttons_Init();
+    Buttons_Set_Repeat(BUTTON_SW5, true); // Holding SW5 switches the clock face
     EduBase_LEDs_Init();
     ADC_Init();
-    Timer0A_Init_1Hz(); // 1Hz tick
+    Light_Sensor_Init(); // Learns the room light until the alarm rings
+    Clock_Start(); // 1Hz tick
+
+    // A time kept across the reset needs no setting
+    time_set_mode = !Clock_Is_Time_Valid();
+    if (time_set_mode)
+    {
+        Dial_Start_Field(time_set_field, temp_hour, temp_minute);
+    }
+    else
+    {
+        Dial_Watch();
+    }
 
     while (1)
     {
+        PROFILE_BEGIN(PROFILE_LOOP_PASS);
+
+        // Deliver the software timers that expired since the last pass
+        PROFILE_BEGIN(PROFILE_LOOP_TIMERS);
+        Soft_Timer_Service();
+        PROFILE_END(PROFILE_LOOP_TIMERS);
+
+        PROFILE_BEGIN(PROFILE_LOOP_LOGIC);
+
+        // Filter the light sensor results that arrived since the last pass
+        Light_Sensor_Service();
+
         // -------- TIME SET MODE --------
         if (time_set_mode)
         {
-            EduBase_LCD_Set_Cursor(0, 0);
-            EduBase_LCD_Display_String("Set Time Mode   ");
-
-            EduBase_LCD_Set_Cursor(0, 1);
-            char buf[17];
-            sprintf(buf, "SET %02d:%02d", temp_hour, temp_minute);
-            EduBase_LCD_Display_String(buf);
+            // The dial turns the selected field
+            uint8_t dial_value;
+            if (Dial_Read(&dial_value))
+            {
+                Set_Field_Value(time_set_field, &temp_hour, &temp_minute, dial_value);
+                time_set_redraw = 1;
+            }
 
-            if (Button_HasEvent())
+            // The buttons are debounced by Buttons.c, so every press counts
+            // Holding SW2 or SW3 repeats with growing speed and minute steps
+            Button_Record record;
+            if (Button_Read_Record(&record) && (record.action != BUTTON_ACTION_RELEASE))
             {
-                ButtonEvent e = Button_GetEvent();
-                switch (e)
+                switch (record.button)
                 {
-                    case BUTTON_SW2_PRESSED:
+                    case BUTTON_SW2:
                         temp_hour = (temp_hour + 1) % 24;
+                        Dial_Start_Field(time_set_field, temp_hour, temp_minute);
                         break;
-                    case BUTTON_SW3_PRESSED:
-                        temp_minute = (temp_minute + 1) % 60;
+                    case BUTTON_SW3:
+                        temp_minute = Step_Up(temp_minute, minute_steps[record.level], 60);
+                        Dial_Start_Field(time_set_field, temp_hour, temp_minute);
                         break;
-                    case BUTTON_SW4_PRESSED:
+                    case BUTTON_SW4:
+                        // Confirm the hour, then the minute sets the time
+                        if (time_set_field == SET_FIELD_HOUR)
+                        {
+                            time_set_field = SET_FIELD_MINUTE;
+                            Dial_Start_Field(time_set_field, temp_hour, temp_minute);
+                            break;
+                        }
                         Clock_Set_Time(temp_hour, temp_minute, 0);
                         time_set_mode = 0;
-                        EduBase_LCD_Set_Cursor(0, 0);
-                        EduBase_LCD_Display_String("Digital Clock   ");
+                        time_set_field = SET_FIELD_HOUR;
+                        Dial_Watch();
+                        Display_Hide_Message();
+                        break;
+#if PROFILE_ENABLED
+                    case BUTTON_SW5:
+                        // Show every probe on the LCD, then start measuring again.
+                        // SW5 repeats while held (face switch), so only the press counts
+                        if (record.action == BUTTON_ACTION_PRESS)
+                        {
+                            Profile_Dump(Profile_LCD_Writer);
+                            Profile_Reset();
+                        }
                         break;
+#endif
                     default:
                         break;
                 }
+                time_set_redraw = 1;
+            }
+
+            // Redraw only when a value or the field changed
+            if (time_set_mode && time_set_redraw)
+            {
+                time_set_redraw = 0;
 
-                SysTick_Delay1ms(250);
+                char buf[17];
+                const uint8_t set_values[2] = { (uint8_t)temp_hour, (uint8_t)temp_minute };
+                Format_Template_Apply(buf, &FORMAT_SET_HHMM, set_values);
+                Display_Show_Message((time_set_field == SET_FIELD_HOUR) ? "Set Time: Hour" : "Set Time: Minute", buf, 0);
             }
         }
 
@@ -131,101 +369,148 @@ int main(void)
             {
                 update_display_flag = 0;
 
-                if (lcd_message_timer > 0)
-                {
-                    lcd_message_timer--;
-                }
-                else
-                {
-                    Display_UpdateTime(
-                        Clock_Get_Hour(),
-                        Clock_Get_Minute(),
-                        Clock_Get_Second()
-                    );
-                }
-
-                if (snooze_mode)
-                {
-                    if (led_flash_timer > 0)
-                    {
-                        led_flash_timer--;
-                        if (led_flash_timer == 0)
-                        {
-                            EduBase_LEDs_Output(0x00); // Turn LEDs OFF
-                            snooze_countdown = 5;      // Start countdown
-                        }
-                    }
-                    else
-                    {
-                        snooze_countdown--;
-                        char cd_buf[8];
-                        sprintf(cd_buf, "CD:%02d", snooze_countdown);
-                        EduBase_LCD_Set_Cursor(11, 1);
-                        EduBase_LCD_Display_String(cd_buf);
-
-                        if (snooze_countdown <= 0)
-                        {
-                            EduBase_LEDs_Output(0x0F); // Flash LEDs
-                            led_flash_timer = 5;       // ON for 5s
-                        }
-                    }
-                }
+                // The clock page is kept current even while a message is shown
+                int hour, minute, second;
+                Clock_Get_Time(&hour, &minute, &second);
+                Display_UpdateTime(hour, minute, second);
             }
 
             // Alarm triggers once
-            if (Clock_Alarm_Is_Enabled() &&
-                Clock_Get_Hour() == alarm_hour &&
-                Clock_Get_Minute() == alarm_minute &&
-                Clock_Get_Second() == alarm_second &&
-                !alarm_triggered_flag)
+            if (Clock_Take_Alarm_Event() && !alarm_triggered_flag)
             {
                 alarm_triggered_flag = 1;
-                snooze_mode = 1;
 
                 EduBase_LEDs_Output(0x0F); // LEDs ON
-                led_flash_timer = 5;       // Stay on 5s
+                Soft_Timer_Start(&led_flash_timer, SNOOZE_FLASH_SECONDS, 0);
+                Light_Sensor_Arm(); // Watch for the sensor being covered
+
+                Display_Show_Message("** ALARM **", "ALARM ACTIVE", MESSAGE_SECONDS);
+            }
 
-                EduBase_LCD_Set_Cursor(0, 1);
-                EduBase_LCD_Display_String("** ALARM ACTIVE **");
+            // Turning the dial starts setting the alarm, hour first
+            if ((alarm_dial_field == SET_FIELD_NONE) && Dial_Take_Turned())
+            {
+                alarm_dial_field = SET_FIELD_HOUR;
+                dial_alarm_hour = alarm_hour;
+                dial_alarm_minute = alarm_minute;
+                Dial_Start_Field(alarm_dial_field, dial_alarm_hour, dial_alarm_minute);
+                Alarm_Dial_Changed();
             }
 
-            // Alarm setup buttons
-            if (Button_HasEvent())
+            uint8_t dial_value;
+            if ((alarm_dial_field != SET_FIELD_NONE) && Dial_Read(&dial_value))
             {
-                ButtonEvent event = Button_GetEvent();
-                switch (event)
+                Set_Field_Value(alarm_dial_field, &dial_alarm_hour, &dial_alarm_minute, dial_value);
+                Alarm_Dial_Changed();
+            }
+
+            // Alarm setup buttons; SW2 and SW3 repeat while held like in time set mode.
+            // While the alarm is dialed they change the dialed time, and SW4 confirms it.
+            // SW5 acts on its release, so holding it can switch the face instead
+            Button_Record record;
+            if (Button_Read_Record(&record) &&
+                ((record.action != BUTTON_ACTION_RELEASE) || (record.button == BUTTON_SW5)))
+            {
+                switch (record.button)
                 {
-                    case BUTTON_SW2_PRESSED:
-                        alarm_hour = (alarm_hour + 1) % 24;
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        EduBase_LCD_Display_String("                ");
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        char buf2[17];
-                        sprintf(buf2, "ALARM %02d:%02d", alarm_hour, alarm_minute);
-                        EduBase_LCD_Display_String(buf2);
-                        lcd_message_timer = 2;
+                    case BUTTON_SW2:
+                        if (alarm_dial_field != SET_FIELD_NONE)
+                        {
+                            dial_alarm_hour = (dial_alarm_hour + 1) % 24;
+                            Dial_Start_Field(alarm_dial_field, dial_alarm_hour, dial_alarm_minute);
+                            Alarm_Dial_Changed();
+                            break;
+                        }
+                        Alarm_Add_Hour();
+                        Show_Alarm_Time();
                         break;
 
-                    case BUTTON_SW3_PRESSED:
-                        Alarm_Add_Minute();
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        EduBase_LCD_Display_String("                ");
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        char buf3[17];
-                        sprintf(buf3, "ALARM %02d:%02d", alarm_hour, alarm_minute);
-                        EduBase_LCD_Display_String(buf3);
-                        lcd_message_timer = 2;
+                    case BUTTON_SW3:
+                        if (alarm_dial_field != SET_FIELD_NONE)
+                        {
+                            dial_alarm_minute = Step_Up(dial_alarm_minute, minute_steps[record.level], 60);
+                            Dial_Start_Field(alarm_dial_field, dial_alarm_hour, dial_alarm_minute);
+                            Alarm_Dial_Changed();
+                            break;
+                        }
+                        Alarm_Add_Minutes(minute_steps[record.level]);
+                        Show_Alarm_Time();
                         break;
 
-                    case BUTTON_SW4_PRESSED:
+                    case BUTTON_SW4:
+                        // A ringing alarm is dismissed first, also in a room too dark for the light sensor
+                        if (alarm_triggered_flag)
+                        {
+                            Alarm_Dismiss();
+                            break;
+                        }
+                        if (alarm_dial_field == SET_FIELD_HOUR)
+                        {
+                            alarm_dial_field = SET_FIELD_MINUTE;
+                            Dial_Start_Field(alarm_dial_field, dial_alarm_hour, dial_alarm_minute);
+                            Alarm_Dial_Changed();
+                            break;
+                        }
+                        if (alarm_dial_field == SET_FIELD_MINUTE)
+                        {
+                            alarm_dial_field = SET_FIELD_NONE;
+                            Soft_Timer_Cancel(&alarm_dial_timer);
+                            Dial_Watch();
+                            Clock_Set_Alarm(dial_alarm_hour, dial_alarm_minute);
+                            Show_Alarm_Time();
+                            break;
+                        }
                         Clock_Toggle_Alarm();
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        EduBase_LCD_Display_String("                ");
-                        EduBase_LCD_Set_Cursor(0, 1);
-                        EduBase_LCD_Display_String(
-                            Clock_Alarm_Is_Enabled() ? "Alarm ON" : "Alarm OFF"
+                        Display_Show_Message("Alarm",
+                            Clock_Alarm_Is_Enabled() ? "Alarm ON" : "Alarm OFF",
+                            MESSAGE_SECONDS
                         );
-                        lcd_message_timer = 2;
+                        break;
+
+                    case BUTTON_SW5:
+                        // Holding SW5 switches the clock face once per hold
+                        if (record.action == BUTTON_ACTION_REPEAT)
+                        {
+                            if (!face_switched)
+                            {
+                                face_switched = 1;
+                                Display_Set_Face((Display_Get_Face() == DISPLAY_FACE_TEXT) ?
+                                    DISPLAY_FACE_BIG_DIGITS : DISPLAY_FACE_TEXT);
+                            }
+                            break;
+                        }
+                        if (record.action == BUTTON_ACTION_PRESS)
+                        {
+                            break;
+                        }
+                        if (face_switched)
+                        {
+                            face_switched = 0;
+                            break;
+                        }
+
+                        // Calibration mode: the first short press starts measuring the drift,
+                        // the second one applies the measured trim
+                        if (!Clock_Calibration_Is_Running())
+                        {
+                            Clock_Calibration_Start();
+                            Display_Show_Message("Calibrating", "SW5 to finish", 0);
+                        }
+                        else
+                        {
+                            int32_t trim;
+                            char buf5[17];
+                            if (Clock_Calibration_Finish(&trim))
+                            {
+                                uint8_t length = Format_Fixed(buf5, trim, 3);
+                                memcpy(&buf5[length], " ppm", 5);
+                                Display_Show_Message("Trim", buf5, MESSAGE_SECONDS);
+                            }
+                            else
+                            {
+                                Display_Show_Message("Calibration", "Too short", MESSAGE_SECONDS);
+                            }
+                        }
                         break;
 
                     default:
@@ -233,30 +518,22 @@ int main(void)
                 }
             }
 
-            // Light sensor dismiss (cover sensor)
-            if (Clock_Alarm_Is_Enabled() && alarm_triggered_flag)
+            // Light sensor dismiss (cover sensor for LIGHT_SENSOR_DWELL_MS)
+            if (Light_Sensor_Take_Dismiss() &&
+                Clock_Alarm_Is_Enabled() && alarm_triggered_flag)
             {
-                ADC_Sample(adc_buffer);
-
-                if (adc_buffer[1] < 0.06)
-                {
-                    Alarm_Off();
-                    EduBase_LEDs_Output(0x00);
-                    EduBase_LCD_Set_Cursor(0, 1);
-                    EduBase_LCD_Display_String("Turned OFF");
-                    lcd_message_timer = 2;
-
-                    // Reset all alarm flags
-                    alarm_triggered_flag = 0;
-                    snooze_mode = 0;
-                    led_flash_timer = 0;
-                    snooze_countdown = 5;
-
-                    // Clear countdown area
-                    EduBase_LCD_Set_Cursor(11, 1);
-                    EduBase_LCD_Display_String("     ");
-                }
+                Alarm_Dismiss();
             }
         }
+
+        PROFILE_END(PROFILE_LOOP_LOGIC);
+
+        // Send only the cells that changed during this pass
+        Display_Refresh();
+
+        PROFILE_END(PROFILE_LOOP_PASS);
+
+        // Sleep until the next interrupt if nothing else is pending
+        Power_Idle(Main_Work_Pending);
     }
 }
@@ -0,0 +1,107 @@
+/**
+ * @file Host.c
+ * @brief Register blocks and core intrinsics of the host stand-in device header.
+ */
+
+#include "TM4C123GH6PM.h"
+#include "Host.h"
+#include <string.h>
+
+GPIOA_Type host_gpio_apb[6];
+GPIOA_Type host_gpio_ahb[6];
+TIMER0_Type host_timer[6];
+SYSCTL_Type host_sysctl;
+HIB_Type host_hib;
+ADC0_Type host_adc0;
+SysTick_Type host_systick;
+SCB_Type host_scb;
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+
+Host_Hook host_on_mask = NULL;
+Host_Hook host_on_unmask = NULL;
+uint32_t host_primask = 0;
+int host_failures = 0;
+
+void Host_Reset(void)
+{
+    memset((void*)host_gpio_apb, 0, sizeof(host_gpio_apb));
+    memset((void*)host_gpio_ahb, 0, sizeof(host_gpio_ahb));
+    memset((void*)host_timer, 0, sizeof(host_timer));
+    memset((void*)&host_sysctl, 0, sizeof(host_sysctl));
+    memset((void*)&host_hib, 0, sizeof(host_hib));
+    memset((void*)&host_adc0, 0, sizeof(host_adc0));
+    memset((void*)&host_systick, 0, sizeof(host_systick));
+    memset((void*)&host_scb, 0, sizeof(host_scb));
+    memset((void*)&host_dwt, 0, sizeof(host_dwt));
+    memset((void*)&host_core_debug, 0, sizeof(host_core_debug));
+
+    // Every peripheral is ready as soon as its clock is enabled
+    host_sysctl.PRTIMER = 0xFF;
+    host_sysctl.PRGPIO = 0xFF;
+    host_sysctl.PRHIB = 0xFF;
+    host_sysctl.PRADC = 0xFF;
+
+    host_on_mask = NULL;
+    host_on_unmask = NULL;
+    host_primask = 0;
+}
+
+int Host_Report(const char* name)
+{
+    if (host_failures == 0)
+    {
+        printf("%s: passed\n", name);
+    }
+    else
+    {
+        printf("%s: %d failed checks\n", name, host_failures);
+    }
+    return (host_failures == 0) ? 0 : 1;
+}
+
+// ==============================
+// Core Intrinsics
+// ==============================
+void NVIC_EnableIRQ(IRQn_Type irq)     { (void)irq; }
+void NVIC_DisableIRQ(IRQn_Type irq)    { (void)irq; }
+void NVIC_SetPendingIRQ(IRQn_Type irq) { (void)irq; }
+
+uint32_t __get_PRIMASK(void)
+{
+    return host_primask;
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+    host_primask = primask & 1;
+    if (!host_primask && (host_on_unmask != NULL))
+    {
+        host_on_unmask();
+    }
+}
+
+void __disable_irq(void)
+{
+    host_primask = 1;
+    if (host_on_mask != NULL)
+    {
+        host_on_mask();
+    }
+}
+
+void __enable_irq(void)
+{
+    __set_PRIMASK(0);
+}
+
+uint32_t __CLZ(uint32_t value)
+{
+    return (value == 0) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+void __DMB(void) {}
+void __DSB(void) {}
+void __ISB(void) {}
+void __WFI(void) {}
+void __NOP(void) {}
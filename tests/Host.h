@@ -0,0 +1,63 @@
+/**
+ * @file Host.h
+ *
+ * @brief Shared helpers of the host tests.
+ *
+ * Each test is a small program that links one or two driver sources with
+ * Host.c and stubs for the rest of the firmware, runs its cases and exits
+ * with the number of failed checks. Build and run them with make in this
+ * directory.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Called when interrupts are masked and when they are unmasked again, or NULL
+typedef void (*Host_Hook)(void);
+extern Host_Hook host_on_mask;
+extern Host_Hook host_on_unmask;
+
+// Current PRIMASK: 1 while interrupts are masked
+extern uint32_t host_primask;
+
+// Number of failed checks so far
+extern int host_failures;
+
+/**
+ * @brief Counts a failed check and prints where it failed.
+ */
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            host_failures++;                                               \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        }                                                                  \
+    } while (0)
+
+/**
+ * @brief Like CHECK, and prints the two values when they differ.
+ */
+#define CHECK_EQUAL(actual, expected)                                      \
+    do {                                                                   \
+        long long check_actual = (long long)(actual);                      \
+        long long check_expected = (long long)(expected);                  \
+        if (check_actual != check_expected) {                              \
+            host_failures++;                                               \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, \
+                   #actual, check_actual, check_expected);                 \
+        }                                                                  \
+    } while (0)
+
+/**
+ * @brief Clears every register block and removes the hooks.
+ */
+void Host_Reset(void);
+
+/**
+ * @brief Prints the result of a test program and returns its exit status.
+ */
+int Host_Report(const char* name);
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host stand-in for the device header, used by the host tests only.
+ *
+ * Declares the register blocks the drivers under test touch, with the same
+ * field names and layout as the device header, and places each block in an
+ * ordinary variable (see Host.c). A test sets a register such as
+ * GPIO_PORTD->DATA or TIMER5->TAV before calling the driver and reads what
+ * the driver wrote afterwards. Registers have no side effects here; a test
+ * that needs one, like a write to ICR clearing RIS, models it itself.
+ *
+ * The core intrinsics are plain functions. Interrupts are modelled by
+ * PRIMASK alone, and tests can hook the points where it is set and cleared.
+ */
+#ifndef TM4C123GH6PM_H
+#define TM4C123GH6PM_H
+
+#include <stdint.h>
+
+#define __IO volatile
+#define __I  volatile const
+#define __O  volatile
+
+typedef enum {
+    GPIOD_IRQn   = 3,
+    ADC0SS0_IRQn = 14,
+    TIMER0A_IRQn = 19,
+    TIMER1A_IRQn = 21,
+    TIMER2A_IRQn = 23,
+    TIMER3A_IRQn = 35,
+    HIB_IRQn     = 43,
+    TIMER4A_IRQn = 70,
+    TIMER5A_IRQn = 92
+} IRQn_Type;
+
+// ==============================
+// Register Blocks
+// ==============================
+typedef struct {
+    __I  uint32_t RESERVED[255];
+    __IO uint32_t DATA, DIR, IS, IBE, IEV, IM, RIS, MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t AFSEL;
+    __I  uint32_t RESERVED1[55];
+    __IO uint32_t DR2R, DR4R, DR8R, ODR, PUR, PDR, SLR, DEN, LOCK, CR, AMSEL, PCTL, ADCCTL, DMACTL;
+} GPIOA_Type;
+
+typedef struct {
+    __IO uint32_t CFG, TAMR, TBMR, CTL, SYNC;
+    __I  uint32_t RESERVED;
+    __IO uint32_t IMR, RIS, MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t TAILR, TBILR, TAMATCHR, TBMATCHR, TAPR, TBPR, TAPMR, TBPMR, TAR, TBR, TAV, TBV;
+    __IO uint32_t RTCPD, TAPS, TBPS, TAPV, TBPV;
+} TIMER0_Type;
+
+typedef struct {
+    __IO uint32_t DID0, DID1, DC0, RESERVED0, DC1, DC2, DC3, DC4, DC5, DC6, DC7, DC8, PBORCTL;
+    __IO uint32_t RESERVED1[7], SRCR0, SRCR1, SRCR2, RESERVED2, RIS, IMC, MISC, RESC, RCC;
+    __IO uint32_t RESERVED3[2], GPIOHBCTL, RCC2, RESERVED4[2], MOSCCTL, DSLPCLKCFG, SYSPROP;
+    __IO uint32_t PIOSCCAL, PLLFREQ0, PLLFREQ1, PLLSTAT, SLPPWRCFG, DSLPPWRCFG;
+    __IO uint32_t RCGCTIMER, RCGCGPIO, RCGCDMA, RCGCHIB, RCGCADC;
+    __IO uint32_t PRTIMER, PRGPIO, PRDMA, PRHIB, PRADC;
+    __IO uint32_t SCGCGPIO, SCGCTIMER, SCGCADC, DCGCGPIO, DCGCTIMER, DCGCADC, DCGCHIB, SCGCHIB;
+} SYSCTL_Type;
+
+// The drivers index the battery-backed words from DATA, so room for all 16 follows it
+typedef struct {
+    __IO uint32_t RTCC, RTCM0, RESERVED, RTCLD, CTL, IM, RIS, MIS, IC, RTCT, RTCSS, RESERVED1, DATA;
+    __IO uint32_t DATA_WORDS[15];
+} HIB_Type;
+
+typedef struct {
+    __IO uint32_t ACTSS, RIS, IM, ISC, OSTAT, EMUX, USTAT, TSSEL, SSPRI, SPC, PSSI, RESERVED, SAC, DCISC, CTL;
+    __IO uint32_t RESERVED1, SSMUX0, SSCTL0, SSFIFO0, SSFSTAT0, SSOP0, SSDC0;
+    __IO uint32_t DCCTL0, DCCMP0;
+} ADC0_Type;
+
+typedef struct {
+    __IO uint32_t CTRL, LOAD, VAL;
+    __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __I  uint32_t CPUID;
+    __IO uint32_t ICSR, VTOR, AIRCR, SCR, CCR;
+} SCB_Type;
+
+typedef struct {
+    __IO uint32_t CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+extern GPIOA_Type host_gpio_apb[6];
+extern GPIOA_Type host_gpio_ahb[6];
+extern TIMER0_Type host_timer[6];
+extern SYSCTL_Type host_sysctl;
+extern HIB_Type host_hib;
+extern ADC0_Type host_adc0;
+extern SysTick_Type host_systick;
+extern SCB_Type host_scb;
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+
+#define GPIOA_BASE     ((uintptr_t)&host_gpio_apb[0])
+#define GPIOB_BASE     ((uintptr_t)&host_gpio_apb[1])
+#define GPIOC_BASE     ((uintptr_t)&host_gpio_apb[2])
+#define GPIOD_BASE     ((uintptr_t)&host_gpio_apb[3])
+#define GPIOE_BASE     ((uintptr_t)&host_gpio_apb[4])
+#define GPIOF_BASE     ((uintptr_t)&host_gpio_apb[5])
+#define GPIOA_AHB_BASE ((uintptr_t)&host_gpio_ahb[0])
+#define GPIOB_AHB_BASE ((uintptr_t)&host_gpio_ahb[1])
+#define GPIOC_AHB_BASE ((uintptr_t)&host_gpio_ahb[2])
+#define GPIOD_AHB_BASE ((uintptr_t)&host_gpio_ahb[3])
+#define GPIOE_AHB_BASE ((uintptr_t)&host_gpio_ahb[4])
+#define GPIOF_AHB_BASE ((uintptr_t)&host_gpio_ahb[5])
+
+#define TIMER0    (&host_timer[0])
+#define TIMER1    (&host_timer[1])
+#define TIMER2    (&host_timer[2])
+#define TIMER3    (&host_timer[3])
+#define TIMER4    (&host_timer[4])
+#define TIMER5    (&host_timer[5])
+#define SYSCTL    (&host_sysctl)
+#define HIB       (&host_hib)
+#define ADC0      (&host_adc0)
+#define SysTick   (&host_systick)
+#define SCB       (&host_scb)
+#define DWT       (&host_dwt)
+#define CoreDebug (&host_core_debug)
+
+#define SCB_SCR_SLEEPDEEP_Msk      (1UL << 2)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+// ==============================
+// Core Intrinsics
+// ==============================
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+uint32_t __CLZ(uint32_t value);
+void __DMB(void);
+void __DSB(void);
+void __ISB(void);
+void __WFI(void);
+void __NOP(void);
+
+#endif
@@ -0,0 +1,466 @@
+/**
+ * @file Test_Buttons.c
+ * @brief Host test of the button debouncing and auto-repeat with bounce waveforms.
+ *
+ * The simulation runs in 1 ms steps. Each step sets the Port D pins, raises
+ * the edge interrupt (GPIOD_Handler) for pins that changed, runs
+ * Buttons_Sample while Timer4A is running, as the 1 kHz Timer4A interrupt
+ * would, and drains the event queue like the main loop.
+ *
+ * Whenever the sampling timer is stopped and the pins have not changed, the
+ * next step samples once more anyway. A stable debouncer does nothing on
+ * that sample and stops again, so any counter left short of its end shows
+ * up as an event or a missing stop.
+ */
+
+#include "TM4C123GH6PM.h"
+#include "Host.h"
+#include "../Buttons.h"
+#include "../GPIO_HAL.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define PIN(button) (1 << (3 - (button)))
+
+void GPIOD_Handler(void);
+
+// ==============================
+// Timer4A and Timebase Stubs
+// ==============================
+static uint32_t now_ms = 0;
+static bool timer_running = false;
+static uint32_t timer_stops = 0;
+
+void Timer4A_Init_1kHz(void) {}
+
+void Timer4A_Start(void)
+{
+    timer_running = true;
+}
+
+void Timer4A_Stop(void)
+{
+    timer_running = false;
+    timer_stops++;
+
+    // Every debounced state must match its pin, and no repeating button may be held
+    uint8_t pins = GPIO_PORTD->DATA & 0x0F;
+    for (int i = 0; i < BUTTON_COUNT; i++)
+    {
+        CHECK_EQUAL(Button_Is_Down((Button_Id)i), (pins & PIN(i)) != 0);
+    }
+    CHECK(!Button_Is_Down(BUTTON_SW2) && !Button_Is_Down(BUTTON_SW3));
+}
+
+uint64_t SysTick_Now_us(void)
+{
+    return (uint64_t)now_ms * 1000;
+}
+
+// ==============================
+// Simulation
+// ==============================
+#define LOG_SIZE 512
+
+static Button_Record event_log[LOG_SIZE];
+static uint32_t event_count = 0;
+static uint8_t last_pins = 0;
+static uint32_t probe_failures = 0;
+
+// Presses and releases of each button, and events out of order (a press of a
+// button that is down or a release of one that is up)
+static uint32_t press_count[BUTTON_COUNT];
+static uint32_t release_count[BUTTON_COUNT];
+static bool seen_down[BUTTON_COUNT];
+static uint32_t order_failures = 0;
+
+static void Sim_Start(void)
+{
+    Host_Reset();
+    GPIO_PORTD->DATA = 0;
+    Buttons_Init();
+
+    now_ms = 0;
+    timer_running = false;
+    timer_stops = 0;
+    event_count = 0;
+    last_pins = 0;
+    probe_failures = 0;
+    order_failures = 0;
+    memset(press_count, 0, sizeof(press_count));
+    memset(release_count, 0, sizeof(release_count));
+    memset(seen_down, 0, sizeof(seen_down));
+}
+
+static void Sim_Record(const Button_Record* record)
+{
+    if (event_count < LOG_SIZE)
+    {
+        event_log[event_count] = *record;
+    }
+    event_count++;
+
+    if (record->action == BUTTON_ACTION_PRESS)
+    {
+        order_failures += seen_down[record->button] ? 1 : 0;
+        seen_down[record->button] = true;
+        press_count[record->button]++;
+    }
+    else if (record->action == BUTTON_ACTION_RELEASE)
+    {
+        order_failures += seen_down[record->button] ? 0 : 1;
+        seen_down[record->button] = false;
+        release_count[record->button]++;
+    }
+    else
+    {
+        order_failures += seen_down[record->button] ? 0 : 1;
+    }
+}
+
+// Runs one millisecond with the given pin levels
+static void Sim_Step(uint8_t pins)
+{
+    pins &= 0x0F;
+    GPIO_PORTD->DATA = pins;
+
+    if (pins != last_pins)
+    {
+        GPIO_PORTD->MIS = (pins ^ last_pins) & GPIO_PORTD->IM;
+        GPIOD_Handler();
+        GPIO_PORTD->MIS = 0;
+    }
+
+    if (timer_running)
+    {
+        Buttons_Sample();
+    }
+    else if (pins == last_pins)
+    {
+        // Probe: a stable debouncer posts nothing and stops again
+        uint32_t stops_before = timer_stops;
+
+        timer_running = true;
+        Buttons_Sample();
+        if (timer_running || (timer_stops != stops_before + 1) || Button_HasEvent())
+        {
+            probe_failures++;
+        }
+        timer_running = false;
+    }
+    last_pins = pins;
+
+    Button_Record record;
+    while (Button_Read_Record(&record))
+    {
+        Sim_Record(&record);
+    }
+    now_ms++;
+}
+
+static void Sim_Hold(uint8_t pins, uint32_t duration_ms)
+{
+    for (uint32_t t = 0; t < duration_ms; t++)
+    {
+        Sim_Step(pins);
+    }
+}
+
+// Plays a waveform of '0' and '1' on a button's pin, one character per millisecond
+static void Sim_Waveform(Button_Id button, const char* waveform)
+{
+    for (const char* c = waveform; *c != '\0'; c++)
+    {
+        uint8_t pins = last_pins & ~PIN(button);
+        if (*c == '1')
+        {
+            pins |= PIN(button);
+        }
+        Sim_Step(pins);
+    }
+}
+
+static uint32_t Count_Events(Button_Id button, Button_Action action)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; (i < event_count) && (i < LOG_SIZE); i++)
+    {
+        if ((event_log[i].button == button) && (event_log[i].action == action))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ==============================
+// Bounce Waveforms
+// ==============================
+
+// Synthetic contact bounce shaped like scope captures: short, then longer runs at the new level
+static const char* const press_bounces[] = {
+    "1",
+    "10",
+    "1010011",
+    "110100101101110111",
+    "1000100110011101110111101111",
+    "0101010101010101010101010101",
+};
+
+static const char* const release_bounces[] = {
+    "0",
+    "01",
+    "0101100",
+    "001011010010001000",
+    "0111011001100010001000010000",
+    "1010101010101010101010101010",
+};
+
+static void Test_Waveforms_Give_One_Pair(void)
+{
+    for (int b = 0; b < BUTTON_COUNT; b++)
+    {
+        for (unsigned w = 0; w < sizeof(press_bounces) / sizeof(press_bounces[0]); w++)
+        {
+            Sim_Start();
+            Sim_Hold(0, 10);
+            Sim_Waveform((Button_Id)b, press_bounces[w]);
+            Sim_Hold(PIN(b), 100);
+            Sim_Waveform((Button_Id)b, release_bounces[w]);
+            Sim_Hold(0, 100);
+
+            CHECK_EQUAL(Count_Events((Button_Id)b, BUTTON_ACTION_PRESS), 1);
+            CHECK_EQUAL(Count_Events((Button_Id)b, BUTTON_ACTION_RELEASE), 1);
+            CHECK_EQUAL(order_failures, 0);
+            CHECK_EQUAL(event_log[0].action, BUTTON_ACTION_PRESS);
+            CHECK_EQUAL(event_log[event_count - 1].action, BUTTON_ACTION_RELEASE);
+            CHECK_EQUAL(timer_running, false);
+            CHECK_EQUAL(probe_failures, 0);
+        }
+    }
+}
+
+static void Test_Random_Bounce(void)
+{
+    // A thousand presses with random bounce of up to 15 ms at both edges, on random buttons
+    Sim_Start();
+    uint32_t seed = 12345;
+    uint32_t presses[BUTTON_COUNT] = { 0 };
+
+    for (int n = 0; n < 1000; n++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        Button_Id button = (Button_Id)((seed >> 28) % BUTTON_COUNT);
+        uint32_t bounce_ms = (seed >> 16) % 16;
+        uint32_t hold_ms = 60 + (seed >> 8) % 200;
+
+        // Bounce settles toward the new level
+        for (uint32_t t = 0; t < bounce_ms; t++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            bool high = ((seed >> 24) % bounce_ms) < t + 1;
+            Sim_Step(high ? PIN(button) : 0);
+        }
+        Sim_Hold(PIN(button), hold_ms);
+        for (uint32_t t = 0; t < bounce_ms; t++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            bool high = ((seed >> 24) % bounce_ms) >= t + 1;
+            Sim_Step(high ? PIN(button) : 0);
+        }
+        Sim_Hold(0, 80);
+        presses[button]++;
+    }
+
+    for (int b = 0; b < BUTTON_COUNT; b++)
+    {
+        CHECK_EQUAL(press_count[b], presses[b]);
+        CHECK_EQUAL(release_count[b], presses[b]);
+        CHECK_EQUAL(Button_Is_Down((Button_Id)b), false);
+    }
+    CHECK_EQUAL(order_failures, 0);
+    CHECK_EQUAL(probe_failures, 0);
+    CHECK_EQUAL(Button_Get_Overflow_Count(), 0);
+    CHECK_EQUAL(timer_running, false);
+}
+
+static void Test_Glitches_Do_Not_Change_State(void)
+{
+    Sim_Start();
+
+    // 1 ms spikes on a released button, e.g. from the buzzer
+    for (int i = 0; i < 20; i++)
+    {
+        Sim_Hold(PIN(BUTTON_SW4), 1);
+        Sim_Hold(0, 9);
+    }
+    CHECK_EQUAL(event_count, 0);
+
+    // 1 ms dropouts on a held button
+    Sim_Hold(PIN(BUTTON_SW4), 100);
+    for (int i = 0; i < 20; i++)
+    {
+        Sim_Hold(0, 1);
+        Sim_Hold(PIN(BUTTON_SW4), 9);
+    }
+    Sim_Hold(0, 100);
+
+    CHECK_EQUAL(Count_Events(BUTTON_SW4, BUTTON_ACTION_PRESS), 1);
+    CHECK_EQUAL(Count_Events(BUTTON_SW4, BUTTON_ACTION_RELEASE), 1);
+    CHECK_EQUAL(probe_failures, 0);
+}
+
+static void Test_Debounce_Window(void)
+{
+    // SW4 changes state after 25 ms at the new level, not before
+    Sim_Start();
+    Sim_Hold(PIN(BUTTON_SW4), 24);
+    CHECK_EQUAL(Button_Is_Down(BUTTON_SW4), false);
+    Sim_Hold(PIN(BUTTON_SW4), 1);
+    CHECK_EQUAL(Button_Is_Down(BUTTON_SW4), true);
+    CHECK_EQUAL(event_log[0].time_us, 24000);
+
+    Sim_Hold(0, 24);
+    CHECK_EQUAL(Button_Is_Down(BUTTON_SW4), true);
+    Sim_Hold(0, 1);
+    CHECK_EQUAL(Button_Is_Down(BUTTON_SW4), false);
+}
+
+static void Test_Overlapping_Buttons(void)
+{
+    // SW3 and SW4 bounce at the same time and are held together
+    Sim_Start();
+    const char* press = "1010011101";
+    for (int t = 0; press[t] != '\0'; t++)
+    {
+        uint8_t level = (press[t] == '1') ? 1 : 0;
+        uint8_t other = (press[9 - t] == '1') ? 1 : 0;
+        Sim_Step((level ? PIN(BUTTON_SW3) : 0) | (other ? PIN(BUTTON_SW4) : 0));
+    }
+    Sim_Hold(PIN(BUTTON_SW3) | PIN(BUTTON_SW4), 200);
+    Sim_Waveform(BUTTON_SW3, "0101100");
+    Sim_Hold(PIN(BUTTON_SW4), 100);
+    Sim_Waveform(BUTTON_SW4, "0010110");
+    Sim_Hold(0, 100);
+
+    CHECK_EQUAL(Count_Events(BUTTON_SW3, BUTTON_ACTION_PRESS), 1);
+    CHECK_EQUAL(Count_Events(BUTTON_SW3, BUTTON_ACTION_RELEASE), 1);
+    CHECK_EQUAL(Count_Events(BUTTON_SW4, BUTTON_ACTION_PRESS), 1);
+    CHECK_EQUAL(Count_Events(BUTTON_SW4, BUTTON_ACTION_RELEASE), 1);
+    CHECK_EQUAL(probe_failures, 0);
+    CHECK_EQUAL(timer_running, false);
+}
+
+// ==============================
+// Auto-Repeat
+// ==============================
+static void Test_Repeat_Acceleration(void)
+{
+    Sim_Start();
+    Sim_Waveform(BUTTON_SW2, "1010011101");
+    Sim_Hold(PIN(BUTTON_SW2), 3000);
+    Sim_Waveform(BUTTON_SW2, "0101100");
+    Sim_Hold(0, 100);
+
+    CHECK_EQUAL(event_log[0].action, BUTTON_ACTION_PRESS);
+    uint64_t last_us = event_log[0].time_us;
+
+    // 500 ms delay, four repeats at 250 ms, ten at 100 ms, then 50 ms
+    uint32_t repeats = 0;
+    for (uint32_t i = 1; i < event_count; i++)
+    {
+        const Button_Record* record = &event_log[i];
+        if (record->action != BUTTON_ACTION_REPEAT)
+        {
+            continue;
+        }
+
+        uint32_t expected_interval_ms;
+        uint8_t expected_level;
+        if (repeats == 0)
+        {
+            expected_interval_ms = BUTTONS_REPEAT_DELAY_MS;
+            expected_level = 0;
+        }
+        else if (repeats < 4)
+        {
+            expected_interval_ms = 250;
+            expected_level = 0;
+        }
+        else if (repeats < 14)
+        {
+            expected_interval_ms = 100;
+            expected_level = 1;
+        }
+        else
+        {
+            expected_interval_ms = 50;
+            expected_level = 2;
+        }
+
+        CHECK_EQUAL(record->button, BUTTON_SW2);
+        CHECK_EQUAL(record->time_us - last_us, expected_interval_ms * 1000);
+        CHECK_EQUAL(record->level, expected_level);
+        last_us = record->time_us;
+        repeats++;
+    }
+
+    // Held for about 3 s: 14 repeats in the first 2.25 s, then one every 50 ms
+    CHECK(repeats >= 27 && repeats <= 29);
+    CHECK_EQUAL(Count_Events(BUTTON_SW2, BUTTON_ACTION_PRESS), 1);
+    CHECK_EQUAL(Count_Events(BUTTON_SW2, BUTTON_ACTION_RELEASE), 1);
+    CHECK_EQUAL(event_log[event_count - 1].action, BUTTON_ACTION_RELEASE);
+    CHECK_EQUAL(timer_running, false);
+}
+
+static void Test_Repeat_Restarts_On_Each_Press(void)
+{
+    Sim_Start();
+    Sim_Hold(PIN(BUTTON_SW3), 2000);
+    Sim_Hold(0, 100);
+
+    // A new press starts at the first level again
+    uint32_t first = event_count;
+    Sim_Hold(PIN(BUTTON_SW3), 35 + 500 + 250);
+    CHECK_EQUAL(event_count - first, 3);
+    CHECK_EQUAL(event_log[first].action, BUTTON_ACTION_PRESS);
+    CHECK_EQUAL(event_log[first + 1].level, 0);
+    CHECK_EQUAL(event_log[first + 2].time_us - event_log[first + 1].time_us, 250000);
+}
+
+static void Test_Timer_Stops_While_Held_Without_Repeat(void)
+{
+    // SW4 does not repeat: once debounced, the sampling stops even though it is held
+    Sim_Start();
+    Sim_Waveform(BUTTON_SW4, "1101");
+    Sim_Hold(PIN(BUTTON_SW4), 26);
+    CHECK_EQUAL(Button_Is_Down(BUTTON_SW4), true);
+    CHECK_EQUAL(timer_running, false);
+
+    uint32_t stops = timer_stops;
+    Sim_Hold(PIN(BUTTON_SW4), 2000);
+    CHECK_EQUAL(timer_stops, stops + 2000);      // One per probe
+    CHECK_EQUAL(Count_Events(BUTTON_SW4, BUTTON_ACTION_REPEAT), 0);
+
+    // A held repeating button keeps it running
+    Sim_Hold(PIN(BUTTON_SW4) | PIN(BUTTON_SW2), 1000);
+    CHECK_EQUAL(timer_running, true);
+    Sim_Hold(PIN(BUTTON_SW4), 100);
+    CHECK_EQUAL(timer_running, false);
+    CHECK_EQUAL(probe_failures, 0);
+}
+
+int main(void)
+{
+    Test_Waveforms_Give_One_Pair();
+    Test_Random_Bounce();
+    Test_Glitches_Do_Not_Change_State();
+    Test_Debounce_Window();
+    Test_Overlapping_Buttons();
+    Test_Repeat_Acceleration();
+    Test_Repeat_Restarts_On_Each_Press();
+    Test_Timer_Stops_While_Held_Without_Repeat();
+
+    return Host_Report("Test_Buttons");
+}
@@ -0,0 +1,335 @@
+/**
+ * @file Test_Clock_Drift.c
+ * @brief Host simulation of the clock's drift trim and calibration.
+ *
+ * The Timer0A backend is built with its real trim path: Timer0A_Set_Trim_ppb
+ * and the fractional accumulator in TIMER0A_Handler (Timer.c), and the
+ * calibration in Clock.c, which measures Timer0A against the Hibernation RTC.
+ * Timer0A runs from a main crystal with a chosen error; the RTC is the exact
+ * reference. Each simulated period lasts TAILR + 1 crystal cycles, with the
+ * reload written by a handler taking effect one timeout later (TAILD).
+ *
+ * The RTC trim is checked by mapping Hib_RTC_Set_Trim_ppb's HIBRTCT value
+ * back to the length of the trimmed 64 s block.
+ *
+ * Both are checked against the target of less than one second per week.
+ */
+
+#include "TM4C123GH6PM.h"
+#include "Host.h"
+#include "../Clock.h"
+#include "../Timer.h"
+#include "../Hib_RTC.h"
+#include "../SysClock.h"
+#include "../Soft_Timer.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define SECONDS_PER_HOUR 3600UL
+#define SECONDS_PER_WEEK 604800UL
+
+// Accuracy target over a week
+#define WEEK_ERROR_LIMIT_S 1.0
+
+void TIMER0A_Handler(void);
+
+// ==============================
+// Firmware Stubs
+// ==============================
+void Alarm_On(void) {}
+void Alarm_Off(void) {}
+void EduBase_LEDs_Output(uint8_t led_value) { (void)led_value; }
+void Buttons_Sample(void) {}
+
+void Soft_Timer_Setup(Soft_Timer* timer, Soft_Timer_Domain domain,
+                      Soft_Timer_Callback callback, void* context)
+{
+    (void)timer;
+    (void)domain;
+    (void)callback;
+    (void)context;
+}
+
+void Soft_Timer_Start(Soft_Timer* timer, uint32_t ticks, uint32_t period)
+{
+    (void)timer;
+    (void)ticks;
+    (void)period;
+}
+
+void Soft_Timer_Tick(Soft_Timer_Domain domain)
+{
+    (void)domain;
+}
+
+// ==============================
+// Timer0A and RTC Model
+// ==============================
+static double crystal_hz;           // Actual rate of the main crystal
+static double true_time_s;          // Time since the simulation started
+static uint32_t period_reload;      // Reload of the period in progress
+
+// Starts the clock with its time base running from a main crystal that is off by error_ppb
+static void Sim_Start(double error_ppb)
+{
+    Host_Reset();
+    HIB->CTL = 0x80000041;          // RTC running, ready for writes
+
+    crystal_hz = (double)F_CPU * (1.0 + error_ppb / 1e9);
+    true_time_s = 0.0;
+
+    Clock_Init();
+    Clock_Start();
+    Clock_Set_Time(0, 0, 0);
+    period_reload = TIMER0->TAILR;
+}
+
+// Sets the RTC counters to the true time
+static void Sim_Set_RTC(void)
+{
+    double seconds = floor(true_time_s);
+
+    HIB->RTCC = (uint32_t)seconds;
+    HIB->RTCSS = (uint32_t)((true_time_s - seconds) * HIB_RTC_SUBSECONDS_HZ);
+}
+
+// Runs one Timer0A period and its timeout interrupt; returns the period's length in cycles
+static uint32_t Sim_Tick(void)
+{
+    uint32_t cycles = period_reload + 1;
+
+    true_time_s += cycles / crystal_hz;
+    Sim_Set_RTC();
+
+    // The reload written by the last handler starts the next period
+    period_reload = TIMER0->TAILR;
+    TIMER0A_Handler();
+    return cycles;
+}
+
+static void Sim_Run(uint32_t ticks)
+{
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        Sim_Tick();
+    }
+}
+
+// Runs a week of ticks and returns how far the clock is off, positive if fast
+static double Sim_Week_Error(void)
+{
+    double start = true_time_s;
+
+    Sim_Run(SECONDS_PER_WEEK);
+    return SECONDS_PER_WEEK - (true_time_s - start);
+}
+
+// ==============================
+// Timer0A Trim
+// ==============================
+static void Test_Trim_Average_Period(void)
+{
+    const int32_t trims[] = { 0, 1, -1, 999, 12345, -12345, 37250, -499999, 500000 };
+
+    for (unsigned i = 0; i < sizeof(trims) / sizeof(trims[0]); i++)
+    {
+        Sim_Start(0);
+        Timer0A_Set_Trim_ppb(trims[i]);
+
+        // The first period still uses the reload from before the trim
+        Sim_Tick();
+        Sim_Tick();
+
+        // Every period is a whole number of cycles next to the exact length,
+        // and the fractions add up exactly over 1000 periods
+        int64_t exact_extra_x1000 = (int64_t)SYSCLOCK_CYCLES_PER_US * trims[i];
+        int64_t total = 0;
+        uint32_t shortest = UINT32_MAX;
+        uint32_t longest = 0;
+
+        for (int n = 0; n < 1000; n++)
+        {
+            uint32_t cycles = Sim_Tick();
+
+            total += cycles;
+            shortest = (cycles < shortest) ? cycles : shortest;
+            longest = (cycles > longest) ? cycles : longest;
+        }
+
+        CHECK_EQUAL(total - 1000LL * F_CPU, exact_extra_x1000);
+        CHECK(longest - shortest <= 1);
+        CHECK((int64_t)shortest * 1000 <= 1000LL * F_CPU + exact_extra_x1000);
+        CHECK((int64_t)longest * 1000 >= 1000LL * F_CPU + exact_extra_x1000);
+    }
+}
+
+static void Test_Trim_Corrects_A_Known_Error(void)
+{
+    const double errors_ppb[] = { 0.0, 20000.0, -20000.0, 37251.3, -108004.7, 499000.0 };
+
+    for (unsigned i = 0; i < sizeof(errors_ppb) / sizeof(errors_ppb[0]); i++)
+    {
+        Sim_Start(errors_ppb[i]);
+        Clock_Set_Trim_ppb((int32_t)lround(errors_ppb[i]));
+        Sim_Run(2);
+
+        double error_s = Sim_Week_Error();
+        CHECK(fabs(error_s) < 0.01);
+    }
+}
+
+// ==============================
+// Calibration
+// ==============================
+
+// Calibrates for an hour, then checks the trim and a week of timekeeping
+static void Calibrate_And_Check(double error_ppb)
+{
+    Sim_Start(error_ppb);
+
+    // Untrimmed, the error is far over the target
+    double untrimmed_s = Sim_Week_Error();
+    if (fabs(error_ppb) > 5000.0)
+    {
+        CHECK(fabs(untrimmed_s) > WEEK_ERROR_LIMIT_S);
+    }
+
+    int32_t trim = 0;
+    Clock_Calibration_Start();
+    CHECK_EQUAL(Clock_Calibration_Is_Running(), 1);
+    Sim_Run(SECONDS_PER_HOUR + 1);
+    CHECK_EQUAL(Clock_Calibration_Finish(&trim), 1);
+    CHECK_EQUAL(Clock_Get_Trim_ppb(), trim);
+
+    // An hour against a 32.768 kHz reference resolves about 8.5 ppb
+    double trim_error_ppb = trim - error_ppb;
+    CHECK(fabs(trim_error_ppb) < 20.0);
+
+    // The trim takes effect one period later
+    Sim_Run(2);
+    double trimmed_s = Sim_Week_Error();
+    CHECK(fabs(trimmed_s) < WEEK_ERROR_LIMIT_S);
+
+    // Calibrating again from the trimmed rate keeps the trim
+    int32_t second_trim = 0;
+    Clock_Calibration_Start();
+    Sim_Run(SECONDS_PER_HOUR + 1);
+    CHECK_EQUAL(Clock_Calibration_Finish(&second_trim), 1);
+    CHECK(fabs(second_trim - error_ppb) < 20.0);
+
+    printf("  crystal %+10.1f ppb: untrimmed %+8.3f s/week, trim %+7d ppb, trimmed %+.4f s/week\n",
+           error_ppb, untrimmed_s, (int)trim, trimmed_s);
+}
+
+static void Test_Calibration(void)
+{
+    Calibrate_And_Check(0.0);
+    Calibrate_And_Check(3000.0);
+    Calibrate_And_Check(20000.0);
+    Calibrate_And_Check(-20000.0);
+    Calibrate_And_Check(47318.6);
+    Calibrate_And_Check(-123456.7);
+    Calibrate_And_Check(480000.0);
+}
+
+static void Test_Calibration_Needs_A_Tick(void)
+{
+    Sim_Start(20000.0);
+
+    int32_t trim = 12;
+    Clock_Calibration_Start();
+    CHECK_EQUAL(Clock_Calibration_Finish(&trim), 0);
+    CHECK_EQUAL(trim, 12);
+    CHECK_EQUAL(Clock_Get_Trim_ppb(), 0);
+}
+
+static void Test_Calibration_Clamps_The_Trim(void)
+{
+    // A measurement far outside the crystal's range is clamped
+    Sim_Start(900000.0);
+
+    int32_t trim = 0;
+    Clock_Calibration_Start();
+    Sim_Run(600);
+    CHECK_EQUAL(Clock_Calibration_Finish(&trim), 1);
+    CHECK_EQUAL(trim, 500000);
+}
+
+// ==============================
+// RTC Trim Mapping
+// ==============================
+
+// HIBRTCT for an untrimmed 64th second, and the subsecond counts in 64 s
+#define RTCT_NOMINAL 0x7FFF
+#define COUNTS_PER_64_S (64.0 * HIB_RTC_SUBSECONDS_HZ)
+
+// Error over a week of an RTC crystal off by error_ppb, trimmed by trim_ppb
+static double RTC_Week_Error(double error_ppb, int32_t trim_ppb)
+{
+    HIB->CTL = 0x80000041;
+    Hib_RTC_Set_Trim_ppb(trim_ppb);
+
+    // The 64th second counts RTCT + 1 subseconds instead of 0x8000
+    double block_counts = COUNTS_PER_64_S + ((double)HIB->RTCT - RTCT_NOMINAL);
+    double block_s = block_counts / (HIB_RTC_SUBSECONDS_HZ * (1.0 + error_ppb / 1e9));
+
+    return SECONDS_PER_WEEK - (SECONDS_PER_WEEK / 64.0) * block_s;
+}
+
+static void Test_RTC_Trim_Register(void)
+{
+    Host_Reset();
+    HIB->CTL = 0x80000041;
+
+    Hib_RTC_Set_Trim_ppb(0);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL);
+
+    // One count in 64 s is 476.8 ppb; the mapping rounds to the nearest count
+    Hib_RTC_Set_Trim_ppb(238);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL);
+    Hib_RTC_Set_Trim_ppb(239);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL + 1);
+    Hib_RTC_Set_Trim_ppb(-239);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL - 1);
+    Hib_RTC_Set_Trim_ppb(20000);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL + 42);
+    Hib_RTC_Set_Trim_ppb(500000);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL + 1049);
+    Hib_RTC_Set_Trim_ppb(-500000);
+    CHECK_EQUAL(HIB->RTCT, RTCT_NOMINAL - 1049);
+}
+
+static void Test_RTC_Trim_Over_A_Week(void)
+{
+    Host_Reset();
+
+    // Sweep the whole trim range; the worst case is half a count per 64 s
+    double worst_s = 0.0;
+    for (int32_t error_ppb = -500000; error_ppb <= 500000; error_ppb += 1013)
+    {
+        double untrimmed_s = RTC_Week_Error(error_ppb, 0);
+        double trimmed_s = RTC_Week_Error(error_ppb, error_ppb);
+
+        if (abs(error_ppb) > 5000)
+        {
+            CHECK(fabs(untrimmed_s) > WEEK_ERROR_LIMIT_S);
+        }
+        CHECK(fabs(trimmed_s) < WEEK_ERROR_LIMIT_S);
+        worst_s = (fabs(trimmed_s) > worst_s) ? fabs(trimmed_s) : worst_s;
+    }
+
+    printf("  RTC trim: worst error %.3f s/week\n", worst_s);
+}
+
+int main(void)
+{
+    Test_Trim_Average_Period();
+    Test_Trim_Corrects_A_Known_Error();
+    Test_Calibration();
+    Test_Calibration_Needs_A_Tick();
+    Test_Calibration_Clamps_The_Trim();
+    Test_RTC_Trim_Register();
+    Test_RTC_Trim_Over_A_Week();
+
+    return Host_Report("Test_Clock_Drift");
+}
@@ -0,0 +1,412 @@
+/**
+ * @file Test_Light_Sensor.c
+ * @brief Host replay of synthetic light sensor traces through Light_Sensor_Feed.
+ *
+ * Each trace first lets the sensor learn the room at the idle rate, then
+ * arms it at the active rate and feeds steps, flicker or slow ramps. The
+ * ADC is replaced by stubs, so the traces exercise the filter, the ambient
+ * baseline, the enter/exit hysteresis, the dwell time and the minimum
+ * baseline exactly as the main loop feeds them.
+ */
+
+#include "Host.h"
+#include "../Light_Sensor.h"
+
+#define ACTIVE_PERIOD_MS (1000 / LIGHT_SENSOR_ACTIVE_RATE_HZ)
+
+// Longest time the filter takes to cross the enter threshold after a step in these traces
+#define FILTER_LAG_MS (10 * ACTIVE_PERIOD_MS)
+
+// ==============================
+// ADC Stubs
+// ==============================
+static uint32_t comparator_starts = 0;
+static uint16_t comparator_low = 0;
+static uint16_t comparator_high = 0;
+static uint16_t comparator_min_count = 0;
+
+void ADC_Start(uint32_t rate_hz) { (void)rate_hz; }
+uint8_t ADC_Has_Samples(void) { return 0; }
+uint8_t ADC_Comparator_Has_Event(void) { return 0; }
+uint8_t ADC_Take_Comparator_Event(void) { return 0; }
+void ADC_Comparator_Stop(void) {}
+
+uint8_t ADC_Read_Samples(uint16_t samples[], uint8_t max_count)
+{
+    (void)samples;
+    (void)max_count;
+    return 0;
+}
+
+void ADC_Comparator_Start(uint16_t low_counts, uint16_t high_counts, uint16_t min_count)
+{
+    comparator_starts++;
+    comparator_low = low_counts;
+    comparator_high = high_counts;
+    comparator_min_count = min_count;
+}
+
+// ==============================
+// Trace Replay
+// ==============================
+static uint32_t now_ms = 0;
+static uint32_t dismiss_count = 0;
+static uint32_t first_dismiss_ms = 0;
+
+// Feeds one result and takes a dismiss the way the main loop does
+static void Feed(uint16_t raw, uint32_t period_ms)
+{
+    Light_Sensor_Feed(raw);
+    now_ms += period_ms;
+
+    if (Light_Sensor_Take_Dismiss())
+    {
+        if (dismiss_count == 0)
+        {
+            first_dismiss_ms = now_ms;
+        }
+        dismiss_count++;
+    }
+}
+
+// Holds a level for a time at the active rate
+static void Hold(uint16_t raw, uint32_t duration_ms)
+{
+    for (uint32_t t = 0; t < duration_ms; t += ACTIVE_PERIOD_MS)
+    {
+        Feed(raw, ACTIVE_PERIOD_MS);
+    }
+}
+
+// Moves linearly from one level to another over a time, at a given rate
+static void Ramp(uint16_t from, uint16_t to, uint32_t duration_ms, uint32_t rate_hz)
+{
+    uint32_t period_ms = 1000 / rate_hz;
+    uint32_t steps = duration_ms / period_ms;
+
+    for (uint32_t i = 0; i <= steps; i++)
+    {
+        int32_t level = from + ((int32_t)to - (int32_t)from) * (int32_t)i / (int32_t)steps;
+        Feed((uint16_t)level, period_ms);
+    }
+}
+
+// Learns a room at the idle rate for ten minutes, then arms the sensor
+static void Start_In_Room(uint16_t ambient)
+{
+    Light_Sensor_Init();
+    now_ms = 0;
+    for (int i = 0; i < 600; i++)
+    {
+        Feed(ambient, 1000 / LIGHT_SENSOR_IDLE_RATE_HZ);
+    }
+    Light_Sensor_Arm_At(LIGHT_SENSOR_ACTIVE_RATE_HZ);
+    dismiss_count = 0;
+    first_dismiss_ms = 0;
+}
+
+// ==============================
+// Baseline
+// ==============================
+static void Test_Baseline_Learns_The_Room(void)
+{
+    Light_Sensor_Init();
+    for (int i = 0; i < 600; i++)
+    {
+        Feed(1000, 1000);
+    }
+    CHECK_EQUAL(Light_Sensor_Get_Baseline(), 1000);
+    CHECK_EQUAL(Light_Sensor_Get_Filtered(), 1000);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+    CHECK_EQUAL(dismiss_count, 0);
+}
+
+static void Test_Baseline_Frozen_While_Armed(void)
+{
+    Start_In_Room(1000);
+
+    // Even a long dim period while armed does not move the baseline
+    Hold(700, 60000);
+    CHECK_EQUAL(Light_Sensor_Get_Baseline(), 1000);
+
+    // Disarmed, it follows the room again
+    Light_Sensor_Disarm();
+    for (int i = 0; i < 600; i++)
+    {
+        Feed(700, 1000);
+    }
+    CHECK_EQUAL(Light_Sensor_Get_Baseline(), 700);
+}
+
+// ==============================
+// Steps
+// ==============================
+static void Test_Step_Cover_Dismisses_After_Dwell(void)
+{
+    Start_In_Room(1000);
+    Hold(1000, 1000);
+    CHECK_EQUAL(dismiss_count, 0);
+
+    // Covered down to 10%: dismissed once the filter is below 40% for the dwell time
+    uint32_t covered_at = now_ms;
+    Hold(100, 2000);
+    CHECK_EQUAL(dismiss_count, 1);
+    CHECK(first_dismiss_ms - covered_at >= LIGHT_SENSOR_DWELL_MS);
+    CHECK(first_dismiss_ms - covered_at <= LIGHT_SENSOR_DWELL_MS + FILTER_LAG_MS);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), true);
+}
+
+static void Test_Short_Cover_Does_Not_Dismiss(void)
+{
+    const uint32_t lengths_ms[] = { 10, 50, 150, 250 };
+
+    for (unsigned i = 0; i < sizeof(lengths_ms) / sizeof(lengths_ms[0]); i++)
+    {
+        Start_In_Room(1000);
+        Hold(1000, 500);
+        Hold(100, lengths_ms[i]);
+        Hold(1000, 2000);
+        CHECK_EQUAL(dismiss_count, 0);
+        CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+    }
+}
+
+static void Test_Shadow_Does_Not_Dismiss(void)
+{
+    // A shadow dims the sensor to half, above the enter threshold
+    Start_In_Room(1000);
+    Hold(500, 5000);
+    CHECK_EQUAL(dismiss_count, 0);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+}
+
+// ==============================
+// Hysteresis
+// ==============================
+static void Test_Hysteresis_Band_Keeps_Cover(void)
+{
+    // Covered at 30%, then the hand lets some light through: 50% stays covered
+    Start_In_Room(1000);
+    uint32_t covered_at = now_ms;
+    Hold(300, 100);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), true);
+    Hold(500, 1000);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), true);
+    CHECK_EQUAL(dismiss_count, 1);
+    CHECK(first_dismiss_ms - covered_at <= LIGHT_SENSOR_DWELL_MS + FILTER_LAG_MS);
+}
+
+static void Test_Hysteresis_Exit_Restarts_Dwell(void)
+{
+    // Covered at 30%, then back above 60% before the dwell time: not dismissed
+    Start_In_Room(1000);
+    Hold(300, 200);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), true);
+    Hold(700, 200);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+    CHECK_EQUAL(dismiss_count, 0);
+
+    // Covering again needs the whole dwell time again
+    uint32_t covered_again_at = now_ms;
+    Hold(300, 1000);
+    CHECK_EQUAL(dismiss_count, 1);
+    CHECK(first_dismiss_ms - covered_again_at >= LIGHT_SENSOR_DWELL_MS);
+}
+
+static void Test_Noise_At_The_Enter_Threshold(void)
+{
+    // A reading wandering around 40% enters once and does not chatter
+    Start_In_Room(1000);
+    uint32_t seed = 7;
+    uint32_t transitions = 0;
+    bool was_covered = false;
+
+    for (int i = 0; i < 300; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        Feed((uint16_t)(360 + (seed >> 24) % 80), ACTIVE_PERIOD_MS);
+
+        if (Light_Sensor_Is_Covered() != was_covered)
+        {
+            transitions++;
+            was_covered = Light_Sensor_Is_Covered();
+        }
+    }
+    CHECK_EQUAL(transitions, 1);
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+// ==============================
+// Flicker
+// ==============================
+static void Test_Flicker_Of_A_Lit_Room(void)
+{
+    // Lamp flicker aliased to every other result: swings between 10% and 100%
+    // average out to 55% and never count as covered
+    Start_In_Room(1000);
+    for (int i = 0; i < 500; i++)
+    {
+        Feed((i & 1) ? 1000 : 100, ACTIVE_PERIOD_MS);
+    }
+    CHECK_EQUAL(dismiss_count, 0);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+}
+
+static void Test_Flicker_Under_A_Hand(void)
+{
+    // The same flicker through a covering hand averages 25% and is dismissed
+    Start_In_Room(1000);
+    for (int i = 0; i < 100; i++)
+    {
+        Feed((i & 1) ? 450 : 50, ACTIVE_PERIOD_MS);
+    }
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+static void Test_Waving_Hand_Does_Not_Dismiss(void)
+{
+    // A hand waved over the sensor: 100 ms covered, 100 ms lit, for 5 s
+    Start_In_Room(1000);
+    for (int i = 0; i < 25; i++)
+    {
+        Hold(100, 100);
+        Hold(1000, 100);
+    }
+    CHECK_EQUAL(dismiss_count, 0);
+}
+
+// ==============================
+// Slow Ramps
+// ==============================
+static void Test_Dusk_Moves_The_Baseline(void)
+{
+    // The room dims from 2000 to 500 over half an hour while the alarm is idle
+    Light_Sensor_Init();
+    now_ms = 0;
+    Ramp(2000, 500, 30 * 60 * 1000, LIGHT_SENSOR_IDLE_RATE_HZ);
+    for (int i = 0; i < 120; i++)
+    {
+        Feed(500, 1000);
+    }
+
+    uint16_t baseline = Light_Sensor_Get_Baseline();
+    CHECK(baseline >= 495 && baseline <= 505);
+
+    // The thresholds follow: a covered sensor in the dim room still dismisses
+    Light_Sensor_Arm_At(LIGHT_SENSOR_ACTIVE_RATE_HZ);
+    dismiss_count = 0;
+    Hold(150, 1000);
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+static void Test_Slow_Dimming_While_Armed(void)
+{
+    // Light fading to 50% over 10 s while ringing stays above the enter threshold
+    Start_In_Room(1000);
+    Ramp(1000, 500, 10000, LIGHT_SENSOR_ACTIVE_RATE_HZ);
+    Hold(500, 2000);
+    CHECK_EQUAL(dismiss_count, 0);
+
+    // Fading on to darkness is a cover, dismissed once past 40% for the dwell time
+    Ramp(500, 0, 5000, LIGHT_SENSOR_ACTIVE_RATE_HZ);
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+// ==============================
+// Minimum Baseline
+// ==============================
+static void Test_Dark_Room_Never_Dismisses(void)
+{
+    // Below the minimum baseline a covered sensor looks like the room
+    Start_In_Room(LIGHT_SENSOR_MIN_BASELINE - 20);
+    Hold(0, 5000);
+    CHECK_EQUAL(dismiss_count, 0);
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), false);
+}
+
+static void Test_Room_At_Minimum_Baseline_Dismisses(void)
+{
+    Start_In_Room(LIGHT_SENSOR_MIN_BASELINE);
+    Hold(0, 1000);
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+// ==============================
+// Arming
+// ==============================
+static void Test_Dwell_Rounds_Up(void)
+{
+    // At 7 Hz the dwell time is three results (428 ms), not two (285 ms)
+    Start_In_Room(1000);
+    Light_Sensor_Arm_At(7);
+
+    for (int i = 0; (i < 20) && !Light_Sensor_Is_Covered(); i++)
+    {
+        Feed(0, 143);
+    }
+    CHECK_EQUAL(Light_Sensor_Is_Covered(), true);
+    CHECK_EQUAL(dismiss_count, 0);
+    Feed(0, 143);
+    CHECK_EQUAL(dismiss_count, 0);
+    Feed(0, 143);
+    CHECK_EQUAL(dismiss_count, 1);
+}
+
+static void Test_Disarm_Drops_A_Pending_Dismiss(void)
+{
+    Start_In_Room(1000);
+
+    // Feed without taking the dismiss, then disarm
+    for (int i = 0; i < 100; i++)
+    {
+        Light_Sensor_Feed(0);
+    }
+    CHECK_EQUAL(Light_Sensor_Has_Work(), true);
+    Light_Sensor_Disarm();
+    CHECK_EQUAL(Light_Sensor_Has_Work(), false);
+    CHECK_EQUAL(Light_Sensor_Take_Dismiss(), false);
+}
+
+static void Test_Arm_Starts_The_Comparator(void)
+{
+    Start_In_Room(1000);
+    comparator_starts = 0;
+    Light_Sensor_Arm();
+
+#if LIGHT_SENSOR_USE_COMPARATOR
+    CHECK_EQUAL(comparator_starts, 1);
+    CHECK_EQUAL(comparator_low, 400);
+    CHECK_EQUAL(comparator_high, 600);
+    CHECK_EQUAL(comparator_min_count, (LIGHT_SENSOR_DWELL_MS * LIGHT_SENSOR_ACTIVE_RATE_HZ) / 1000);
+#endif
+
+    // Not in a room too dark to watch
+    Start_In_Room(LIGHT_SENSOR_MIN_BASELINE - 1);
+    comparator_starts = 0;
+    Light_Sensor_Arm();
+    CHECK_EQUAL(comparator_starts, 0);
+}
+
+int main(void)
+{
+    Test_Baseline_Learns_The_Room();
+    Test_Baseline_Frozen_While_Armed();
+    Test_Step_Cover_Dismisses_After_Dwell();
+    Test_Short_Cover_Does_Not_Dismiss();
+    Test_Shadow_Does_Not_Dismiss();
+    Test_Hysteresis_Band_Keeps_Cover();
+    Test_Hysteresis_Exit_Restarts_Dwell();
+    Test_Noise_At_The_Enter_Threshold();
+    Test_Flicker_Of_A_Lit_Room();
+    Test_Flicker_Under_A_Hand();
+    Test_Waving_Hand_Does_Not_Dismiss();
+    Test_Dusk_Moves_The_Baseline();
+    Test_Slow_Dimming_While_Armed();
+    Test_Dark_Room_Never_Dismisses();
+    Test_Room_At_Minimum_Baseline_Dismisses();
+    Test_Dwell_Rounds_Up();
+    Test_Disarm_Drops_A_Pending_Dismiss();
+    Test_Arm_Starts_The_Comparator();
+
+    return Host_Report("Test_Light_Sensor");
+}
@@ -0,0 +1,328 @@
+/**
+ * @file Test_SysTick_Delay.c
+ * @brief Host test of the 64-bit timebase and the delays built on it.
+ *
+ * Timer5A is modelled as a 32-bit down-counter driven by a simulated cycle
+ * count. Every read of the timebase masks interrupts, and the model lets
+ * POLL_CYCLES pass at that point, as a polling loop on the board would. A
+ * wrap that happens with interrupts masked leaves the interrupt pending
+ * (RIS set) until they are unmasked, so the re-read path of
+ * SysTick_Now_Cycles runs whenever a read lands on a wrap.
+ */
+
+#include "TM4C123GH6PM.h"
+#include "Host.h"
+#include "../SysTick_Delay.h"
+#include "../Power.h"
+
+#define WRAP_CYCLES (1ULL << 32)
+
+// Cycles that pass on every read of the timebase
+#define POLL_CYCLES 37
+
+// Cycles between the 1 ms wakeups of a sleeping delay
+#define SLEEP_WAKE_CYCLES (1000ULL * SYSTICK_CYCLES_PER_US)
+
+static uint64_t sim_cycles = 0;
+static uint64_t poll_cycles = POLL_CYCLES;
+static uint32_t sleep_calls = 0;
+
+// Runs the wrap interrupt if it is pending and not masked
+static void Sim_Service_Interrupt(void)
+{
+    if (!host_primask && (TIMER5->RIS & 0x01) && (TIMER5->IMR & 0x01))
+    {
+        TIMER5->ICR = 0;
+        TIMER5A_Handler();
+        TIMER5->RIS &= ~TIMER5->ICR;
+    }
+}
+
+// Advances the timer by a number of cycles, taking every wrap on the way
+static void Sim_Advance(uint64_t cycles)
+{
+    while (cycles > 0)
+    {
+        uint64_t to_wrap = WRAP_CYCLES - (sim_cycles % WRAP_CYCLES);
+        uint64_t step = (cycles < to_wrap) ? cycles : to_wrap;
+
+        sim_cycles += step;
+        cycles -= step;
+        TIMER5->TAV = (uint32_t)(0xFFFFFFFFULL - (sim_cycles % WRAP_CYCLES));
+
+        if ((sim_cycles % WRAP_CYCLES) == 0)
+        {
+            TIMER5->RIS |= 0x01;
+            Sim_Service_Interrupt();
+        }
+    }
+}
+
+static void Sim_On_Mask(void)
+{
+    Sim_Advance(poll_cycles);
+}
+
+// Starts the timebase at a cycle count, as if it had been running since zero
+static void Sim_Start(uint64_t start_cycles)
+{
+    Host_Reset();
+    host_on_mask = Sim_On_Mask;
+    host_on_unmask = Sim_Service_Interrupt;
+
+    sim_cycles = 0;
+    poll_cycles = 0;
+    SysTick_Delay_Init();
+    TIMER5->TAV = 0xFFFFFFFF;
+    Sim_Advance(start_cycles);
+    poll_cycles = POLL_CYCLES;
+}
+
+// The sleeping path of the delays: wakes every millisecond until the deadline
+void Power_Sleep_Until(const SysTick_Deadline* deadline)
+{
+    sleep_calls++;
+    while (!SysTick_Deadline_Expired(deadline))
+    {
+        Sim_Advance(SLEEP_WAKE_CYCLES);
+    }
+}
+
+// ==============================
+// Reading the Timebase
+// ==============================
+static void Test_Init(void)
+{
+    Sim_Start(0);
+
+    CHECK_EQUAL(SysTick->CTRL, 0);
+    CHECK_EQUAL(TIMER5->TAILR, 0xFFFFFFFF);
+    CHECK_EQUAL(TIMER5->TAMR, 0x02);
+    CHECK_EQUAL(TIMER5->CTL & 0x01, 1);
+    CHECK_EQUAL(TIMER5->IMR & 0x01, 1);
+}
+
+static void Test_Reads_Match_The_Counter(void)
+{
+    Sim_Start(0);
+    poll_cycles = 0;
+
+    uint64_t points[] = { 0, 1, WRAP_CYCLES - 1, WRAP_CYCLES, WRAP_CYCLES + 1,
+                          5 * WRAP_CYCLES - 2, 1000 * WRAP_CYCLES + 12345 };
+
+    for (unsigned i = 0; i < sizeof(points) / sizeof(points[0]); i++)
+    {
+        Sim_Advance(points[i] - sim_cycles);
+        CHECK_EQUAL(SysTick_Now_Cycles(), points[i]);
+    }
+}
+
+static void Test_Wrap_Pending_While_Masked(void)
+{
+    // Mask interrupts, then let the counter wrap: the interrupt stays pending
+    Sim_Start(WRAP_CYCLES - 100);
+    poll_cycles = 0;
+
+    uint64_t before = SysTick_Now_Cycles();
+    __disable_irq();
+    Sim_Advance(250);
+    CHECK_EQUAL(TIMER5->RIS & 0x01, 1);
+
+    uint64_t during = SysTick_Now_Cycles();
+    CHECK_EQUAL(during, WRAP_CYCLES + 150);
+    CHECK(during > before);
+
+    // The interrupt runs once unmasked and the count does not jump
+    __enable_irq();
+    CHECK_EQUAL(TIMER5->RIS & 0x01, 0);
+    CHECK_EQUAL(SysTick_Now_Cycles(), WRAP_CYCLES + 150);
+}
+
+static void Test_Monotonic_Across_Wraps(void)
+{
+    // Step over several wraps with steps that land on, before and after each one
+    Sim_Start(WRAP_CYCLES - 5000);
+
+    uint64_t last = SysTick_Now_Cycles();
+    uint32_t decreases = 0;
+    uint32_t mismatches = 0;
+    uint32_t seed = 1;
+
+    while (sim_cycles < 4 * WRAP_CYCLES)
+    {
+        seed = seed * 1664525 + 1013904223;
+        poll_cycles = 1 + (seed >> 24);
+
+        uint64_t now = SysTick_Now_Cycles();
+        if (now < last)
+        {
+            decreases++;
+        }
+        if (now != sim_cycles)
+        {
+            mismatches++;
+        }
+        last = now;
+
+        // Jump close to the next wrap once the current one is behind us
+        uint64_t to_wrap = WRAP_CYCLES - (sim_cycles % WRAP_CYCLES);
+        if (to_wrap > 10000)
+        {
+            Sim_Advance(to_wrap - 2000);
+        }
+    }
+
+    CHECK_EQUAL(decreases, 0);
+    CHECK_EQUAL(mismatches, 0);
+}
+
+// ==============================
+// Deadlines
+// ==============================
+static void Test_Deadline_Remaining_Rounds_Up(void)
+{
+    Sim_Start(WRAP_CYCLES - 200);
+    poll_cycles = 0;
+
+    SysTick_Deadline deadline;
+    SysTick_Deadline_Set_us(&deadline, 5);
+    CHECK_EQUAL(deadline.expiry_cycles, sim_cycles + 5 * SYSTICK_CYCLES_PER_US);
+
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 5);
+    Sim_Advance(1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 5);
+    Sim_Advance(SYSTICK_CYCLES_PER_US - 1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 4);
+    Sim_Advance(3 * SYSTICK_CYCLES_PER_US + 1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 1);
+    CHECK_EQUAL(SysTick_Deadline_Expired(&deadline), 0);
+    Sim_Advance(SYSTICK_CYCLES_PER_US - 2);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 1);
+    Sim_Advance(1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 0);
+    CHECK_EQUAL(SysTick_Deadline_Expired(&deadline), 1);
+    Sim_Advance(1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 0);
+
+    // A zero-initialized deadline has always expired
+    SysTick_Deadline zero = { 0 };
+    CHECK_EQUAL(SysTick_Deadline_Expired(&zero), 1);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&zero), 0);
+}
+
+static void Test_Deadline_ms_Past_A_Wrap(void)
+{
+    Sim_Start(WRAP_CYCLES - 1000);
+    poll_cycles = 0;
+
+    SysTick_Deadline deadline;
+    SysTick_Deadline_Set_ms(&deadline, 120000);
+    CHECK_EQUAL(SysTick_Deadline_Remaining_us(&deadline), 120000000);
+
+    Sim_Advance(120000ULL * 1000 * SYSTICK_CYCLES_PER_US - 1);
+    CHECK_EQUAL(SysTick_Deadline_Expired(&deadline), 0);
+    Sim_Advance(1);
+    CHECK_EQUAL(SysTick_Deadline_Expired(&deadline), 1);
+}
+
+// ==============================
+// Delay Lengths
+// ==============================
+
+// A spinning delay ends on the first poll at or past its deadline
+#define SPIN_SLACK_CYCLES (3 * POLL_CYCLES)
+
+// A sleeping delay ends on the first 1 ms wakeup at or past its deadline
+#define SLEEP_SLACK_CYCLES (SLEEP_WAKE_CYCLES + 3 * POLL_CYCLES)
+
+static void Check_Delay(uint64_t requested_cycles, uint64_t elapsed, uint32_t slept, uint8_t should_sleep)
+{
+    uint64_t slack = should_sleep ? SLEEP_SLACK_CYCLES : SPIN_SLACK_CYCLES;
+
+    CHECK(elapsed >= requested_cycles);
+    CHECK(elapsed <= requested_cycles + slack);
+    CHECK_EQUAL(slept, should_sleep);
+
+    if ((elapsed < requested_cycles) || (elapsed > requested_cycles + slack))
+    {
+        printf("  requested %llu cycles, took %llu\n",
+               (unsigned long long)requested_cycles, (unsigned long long)elapsed);
+    }
+}
+
+static void Test_Delay_us_Lengths(void)
+{
+    const uint32_t lengths[] = {
+        0, 1, 2, 3, 10, 53, 100, 999, 1000, 1999, POWER_SLEEP_MIN_US - 1,
+        POWER_SLEEP_MIN_US, POWER_SLEEP_MIN_US + 1, 5000, 99999, 1000000,
+        60000000, 300000000, 0xFFFFFFFF
+    };
+
+    for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        // Start a little before a wrap so the delays cross at least one
+        Sim_Start(3 * WRAP_CYCLES - 300 - i * 7);
+        sleep_calls = 0;
+
+        uint64_t start = SysTick_Now_Cycles();
+        SysTick_Delay1us(lengths[i]);
+        uint64_t elapsed = sim_cycles - start;
+
+        Check_Delay((uint64_t)lengths[i] * SYSTICK_CYCLES_PER_US, elapsed, sleep_calls,
+                    lengths[i] >= POWER_SLEEP_MIN_US);
+    }
+}
+
+static void Test_Delay_ms_Lengths(void)
+{
+    const uint32_t lengths[] = {
+        0, 1, (POWER_SLEEP_MIN_US / 1000) - 1, POWER_SLEEP_MIN_US / 1000, 3, 10, 250,
+        1000, 53687, 60000, 600000
+    };
+
+    for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        Sim_Start(7 * WRAP_CYCLES - 300 - i * 11);
+        sleep_calls = 0;
+
+        uint64_t start = SysTick_Now_Cycles();
+        SysTick_Delay1ms(lengths[i]);
+        uint64_t elapsed = sim_cycles - start;
+
+        Check_Delay((uint64_t)lengths[i] * 1000 * SYSTICK_CYCLES_PER_US, elapsed, sleep_calls,
+                    lengths[i] >= (POWER_SLEEP_MIN_US / 1000));
+    }
+}
+
+static void Test_Delay_Cycles_Lengths(void)
+{
+    const uint32_t lengths[] = { 0, 1, 12, SYSTICK_CYCLES_FROM_NS(450), 1000, 123456 };
+
+    for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        Sim_Start(WRAP_CYCLES - 50);
+
+        uint64_t start = sim_cycles;
+        SysTick_Delay_Cycles(lengths[i]);
+        uint64_t elapsed = sim_cycles - start;
+
+        // The start read itself counts toward the delay
+        CHECK(elapsed >= lengths[i]);
+        CHECK(elapsed <= lengths[i] + SPIN_SLACK_CYCLES);
+    }
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Reads_Match_The_Counter();
+    Test_Wrap_Pending_While_Masked();
+    Test_Monotonic_Across_Wraps();
+    Test_Deadline_Remaining_Rounds_Up();
+    Test_Deadline_ms_Past_A_Wrap();
+    Test_Delay_us_Lengths();
+    Test_Delay_ms_Lengths();
+    Test_Delay_Cycles_Lengths();
+
+    return Host_Report("Test_SysTick_Delay");
+}